@@ -1,7 +1,7 @@
 -- DataSource.lua
 -- Unified data source handler for both Online (UDP) and Offline (file playback) modes
 -- Replaces both C++ NetworkReceiverThread and offline file loading
--- This script runs as a frame callback at ~60 FPS
+-- This script runs as a frame callback on the ingest tick (60 Hz by default, independent of rendering)
 
 print("========================================")
 print("DataSource.lua - Unified Online/Offline Data Handler")
@@ -23,6 +23,11 @@ local sharedBuffer = SharedBuffer.new(RECV_BUFFER_SIZE)
 local rawPtr = sharedBuffer:get_ptr() -- sol::lightuserdata (raw address)
 local recvBuffer = ffi.cast("uint8_t*", rawPtr) -- FFI pointer for data access
 
+-- Offline logs at least this large keep their decoded columns in memory-mapped
+-- cache files (out of core) instead of the heap. Smaller logs stay in memory,
+-- where the memory budget can compress, downsample or spill them as needed.
+local MAPPED_STORAGE_MIN_BYTES = 256 * 1024 * 1024
+
 -- ==================== HELPER FUNCTIONS ====================
 
 -- Get configuration from GUI controls
@@ -175,12 +180,6 @@ local function loadOfflineFile(filepath)
     print(string.format("[DataSource] Offline: Loading file: %s", filepath))
     offlineLoading = true
 
-    -- Set default mode to offline so all new signals grow indefinitely
-    set_default_signal_mode("offline")
-
-    -- Clear all existing signals
-    clear_all_signals()
-
     -- Open file in binary mode
     local file = io.open(filepath, "rb")
     if not file then
@@ -196,6 +195,19 @@ local function loadOfflineFile(filepath)
 
     print(string.format("[DataSource] Offline: File size: %d bytes", fileSize))
 
+    -- Set default mode to offline so all new signals grow indefinitely
+    set_default_signal_mode("offline")
+
+    -- Only logs too large for comfort in RAM go to memory-mapped cache files
+    if fileSize >= MAPPED_STORAGE_MIN_BYTES then
+        set_offline_storage("mapped")
+    else
+        set_offline_storage("memory")
+    end
+
+    -- Clear all existing signals
+    clear_all_signals()
+
     -- Parse entire file to populate signals (static viewer - no playback)
     local currentPos = 0
     local packetsProcessed = 0
@@ -14,6 +14,7 @@
 #include <atomic>
 #include <chrono>
 #include "types.hpp"
+#include "signal_registry.hpp"
 #include "ui_state.hpp"
 #include "ImGuiFileDialog.h"
 
@@ -419,29 +420,24 @@ public:
 
             PlaybackMode playbackMode = (mode == "offline") ? PlaybackMode::OFFLINE : PlaybackMode::ONLINE;
 
-            auto it = currentSignalRegistry->find(name);
-            if (it != currentSignalRegistry->end()) {
-                it->second.SetMode(playbackMode);
-            } else {
-                // Create new signal in the specified mode
-                (*currentSignalRegistry)[name] = Signal(name, 10000, playbackMode);
+            // Create the signal in the specified mode, or switch an existing one
+            bool created = false;
+            Signal* sig = currentSignalRegistry->Get(currentSignalRegistry->Register(name, 10000, playbackMode, &created));
+            if (sig && !created) {
+                sig->SetMode(playbackMode);
             }
         });
 
         // Clear all signals (useful when loading a new offline file)
         lua.set_function("clear_all_signals", [this]() {
-            std::map<std::string, Signal>* registry = currentSignalRegistry ? currentSignalRegistry : defaultSignalRegistry;
+            SignalRegistry* registry = currentSignalRegistry ? currentSignalRegistry : defaultSignalRegistry;
             if (registry == nullptr) {
                 printf("[Lua] Warning: Cannot clear signals - no active signal registry\n");
                 return;
             }
             
-            size_t count = 0;
-            for (auto& pair : *registry) {
-                pair.second.Clear();
-                count++;
-            }
-            printf("[LuaScriptManager] Cleared data for %zu signals (maintained registry names and IDs)\n", count);
+            registry->ClearAll();
+            printf("[LuaScriptManager] Cleared data for %zu signals (maintained registry names and IDs)\n", registry->Count());
         });
 
         // Set the default playback mode for newly created signals
@@ -455,6 +451,20 @@ public:
             }
         });
 
+        // Choose where offline samples live: "memory" (heap chunks) or "mapped"
+        // (memory-mapped column files in a cache directory, for logs larger than RAM).
+        // Applies to offline signals created or cleared afterwards.
+        lua.set_function("set_offline_storage", [](const std::string& backend, sol::optional<std::string> directory) {
+            if (backend == "mapped") {
+                std::string dir = directory.value_or(MappedFile::TempDirectory());
+                GetOfflineStorage().SetMapped(dir);
+                printf("[Lua] Offline storage set to mapped files in %s\n", dir.c_str());
+            } else {
+                GetOfflineStorage().SetMemory();
+                printf("[Lua] Offline storage set to memory\n");
+            }
+        });
+
         // File dialog support for offline playback
         lua.set_function("open_file_dialog", [](const std::string& dialogKey, const std::string& title, const std::string& filters) {
             IGFD::FileDialogConfig config;
@@ -574,7 +584,7 @@ public:
     // deltaTime: time since last frame in seconds
     // plotCount: number of active plots
     // uiPlotState: UI state for accessing control elements (Tier 4)
-    void executeFrameCallbacks(std::map<std::string, Signal>& signalRegistry,
+    void executeFrameCallbacks(SignalRegistry& signalRegistry,
                               uint64_t frameNumber,
                               double deltaTime,
                               int plotCount,
@@ -647,7 +657,7 @@ public:
     // NOTE: Caller must hold stateMutex lock before calling this function
     // Returns true if at least one parser handled the packet
     // If selectedParser is not empty, only that parser will be used
-    bool parsePacket(const char* buffer, size_t length, std::map<std::string, Signal>& signalRegistry, PlaybackMode mode = PlaybackMode::ONLINE, const std::string& selectedParser = "") {
+    bool parsePacket(const char* buffer, size_t length, SignalRegistry& signalRegistry, PlaybackMode mode = PlaybackMode::ONLINE, const std::string& selectedParser = "") {
         // Set the registry so Lua functions can access it
         currentSignalRegistry = &signalRegistry;
 
@@ -693,7 +703,7 @@ public:
 
     // Tier 5: Zero-Copy Packet Parsing (FFI Support)
     // Returns true if handled.
-    bool parsePacket(const void* data, size_t length, std::map<std::string, Signal>& signalRegistry, const std::string& selectedParser = "") {
+    bool parsePacket(const void* data, size_t length, SignalRegistry& signalRegistry, const std::string& selectedParser = "") {
         currentSignalRegistry = &signalRegistry;
         bool handled = false;
 
@@ -735,7 +745,7 @@ public:
     }
 
     // Set a default signal registry to be used when no frame/packet context is active (e.g. at script load)
-    void setSignalRegistry(std::map<std::string, Signal>* registry) {
+    void setSignalRegistry(SignalRegistry* registry) {
         defaultSignalRegistry = registry;
     }
 
@@ -753,16 +763,7 @@ public:
         printf("[LuaScriptManager] All Lua threads stopped\n");
     }
 
-    // Clear the fast access cache (call when registry is cleared or pointers might be invalid)
-    void clearSignalCache() {
-        signalCache.clear();
-        signalNameCache.clear();
-    }
-
 private:
-    // Fast access signal cache
-    std::vector<Signal*> signalCache;
-    std::unordered_map<std::string, int> signalNameCache;
     sol::state lua;
     std::vector<LuaScript> scripts;
 
@@ -789,10 +790,10 @@ private:
     std::vector<Alert> alerts;
 
     // Pointer to signal registry (set during executeFrameCallbacks or parsePacket)
-    std::map<std::string, Signal>* currentSignalRegistry = nullptr;
+    SignalRegistry* currentSignalRegistry = nullptr;
 
     // Default pointer to signal registry (fallback when currentSignalRegistry is null)
-    std::map<std::string, Signal>* defaultSignalRegistry = nullptr;
+    SignalRegistry* defaultSignalRegistry = nullptr;
 
     // Default playback mode for new signals (changed by set_default_signal_mode)
     PlaybackMode defaultSignalMode = PlaybackMode::ONLINE;
@@ -968,7 +969,7 @@ private:
 
         // Signal manipulation functions
         lua.set_function("update_signal", [this](const std::string& name, double timestamp, double value) {
-            std::map<std::string, Signal>* registry = currentSignalRegistry ? currentSignalRegistry : defaultSignalRegistry;
+            SignalRegistry* registry = currentSignalRegistry ? currentSignalRegistry : defaultSignalRegistry;
             
             if (registry == nullptr) {
                 printf("[Lua] Warning: Cannot update signal '%s' - no active signal registry\n", name.c_str());
@@ -976,52 +977,43 @@ private:
             }
 
             // Get or create the signal (using default mode)
-            if (registry->find(name) == registry->end()) {
-                (*registry)[name] = Signal(name, 10000, defaultSignalMode);
+            if (Signal* sig = registry->Get(registry->Register(name, 10000, defaultSignalMode))) {
+                sig->AddPoint(timestamp, value);
             }
-
-            Signal& sig = (*registry)[name];
-            sig.AddPoint(timestamp, value);
         });
 
         lua.set_function("create_signal", [this](const std::string& name) {
-            std::map<std::string, Signal>* registry = currentSignalRegistry ? currentSignalRegistry : defaultSignalRegistry;
+            SignalRegistry* registry = currentSignalRegistry ? currentSignalRegistry : defaultSignalRegistry;
 
             if (registry == nullptr) {
                 printf("[Lua] Warning: Cannot create signal '%s' - no active signal registry\n", name.c_str());
                 return;
             }
 
-            if (registry->find(name) == registry->end()) {
-                (*registry)[name] = Signal(name, 10000, PlaybackMode::ONLINE);
+            bool created = false;
+            registry->Register(name, 10000, PlaybackMode::ONLINE, &created);
+            if (created) {
                 printf("[Lua] Created signal: %s\n", name.c_str());
             }
         });
     }
 
     // Get current timestamp for a packet type by looking at its signals
-    double getCurrentTimestamp(std::map<std::string, Signal>& signalRegistry, const std::string& packetType) {
+    double getCurrentTimestamp(SignalRegistry& signalRegistry, const std::string& packetType) {
         double currentTime = 0.0;
 
         // Look for signals belonging to this packet type (e.g., "IMU.accelX" for packet "IMU")
-        for (const auto& [name, sig] : signalRegistry) {
+        std::string prefix = packetType + ".";
+        signalRegistry.ForEach([&](const Signal& sig) {
             // Check if signal name starts with packetType
-            if (name.find(packetType + ".") == 0 && !sig.dataX.empty()) {
-                double lastTime;
-                if (sig.mode == PlaybackMode::ONLINE && sig.dataX.size() >= sig.maxSize) {
-                    // Circular buffer is full - latest value is at (offset - 1)
-                    int latestIndex = (sig.offset - 1 + sig.maxSize) % sig.maxSize;
-                    lastTime = sig.dataX[latestIndex];
-                } else {
-                    // Buffer not full yet, or offline mode - latest is at back()
-                    lastTime = sig.dataX.back();
-                }
+            if (sig.name.compare(0, prefix.size(), prefix) == 0 && !sig.Empty()) {
+                double lastTime = sig.LatestX();
 
                 if (lastTime > currentTime) {
                     currentTime = lastTime;
                 }
             }
-        }
+        });
 
         return currentTime;
     }
@@ -1040,26 +1032,17 @@ private:
                 return sol::nullopt;
             }
 
-            auto it = currentSignalRegistry->find(name);
-            if (it == currentSignalRegistry->end() || it->second.dataY.empty()) {
+            const Signal* sig = currentSignalRegistry->Find(name);
+            if (sig == nullptr) {
                 return sol::nullopt;
             }
 
-            // Get the latest value from the circular buffer
-            const Signal& sig = it->second;
-            if (sig.dataY.empty()) {
+            // Lock-free read of the newest sample (consistent even mid-ingest)
+            double x, y;
+            if (!sig->ReadLatest(x, y)) {
                 return sol::nullopt;
             }
-
-            // Account for circular buffer - latest value is at (offset - 1), not back()
-            if (sig.mode == PlaybackMode::ONLINE && sig.dataY.size() >= sig.maxSize) {
-                // Circular buffer is full
-                int latestIndex = (sig.offset - 1 + sig.maxSize) % sig.maxSize;
-                return sig.dataY[latestIndex];
-            } else {
-                // Buffer not full yet, or offline mode
-                return sig.dataY.back();
-            }
+            return y;
         });
 
         // Function to get N latest values of a signal
@@ -1068,23 +1051,72 @@ private:
                 return sol::nullopt;
             }
 
-            auto it = currentSignalRegistry->find(name);
-            if (it == currentSignalRegistry->end()) {
+            const Signal* sig = currentSignalRegistry->Find(name);
+            if (sig == nullptr) {
                 return sol::nullopt;
             }
 
-            const Signal& sig = it->second;
-            int available = (int)sig.dataY.size();
-            int n = std::min(count, available);
+            size_t n = (size_t)std::max(0, count);
+            n = std::min(n, sig->Snapshot().size);
+
+            // Lock-free copy of the newest n samples, oldest first
+            std::vector<double> times(n);
+            std::vector<double> result(n);
+            result.resize(sig->CopyTail(n, times.data(), result.data()));
+
+            return result;
+        });
+
+        // Running statistics of a signal, maintained as samples arrive (no buffer scan).
+        // windowed (default true): samples currently held; false: everything since the last clear
+        lua.set_function("get_signal_stats", [this](const std::string& name, sol::optional<bool> windowed) -> sol::object {
+            if (currentSignalRegistry == nullptr) {
+                return sol::lua_nil;
+            }
+
+            const Signal* sig = currentSignalRegistry->Find(name);
+            if (sig == nullptr) {
+                return sol::lua_nil;
+            }
 
-            std::vector<double> result;
-            result.reserve(n);
+            RunningStats st = sig->Stats(windowed.value_or(true));
+            if (st.count == 0) {
+                return sol::lua_nil;
+            }
+            sol::table result = lua.create_table();
+            result.set("count", (double)st.count);
+            result.set("min", st.min);
+            result.set("max", st.max);
+            result.set("mean", st.mean);
+            result.set("stddev", st.StdDev());
+            result.set("rms", st.Rms());
+            result.set("last", st.last);
+            return sol::make_object(lua, result);
+        });
 
-            for (int i = available - n; i < available; i++) {
-                result.push_back(sig.dataY[i]);
+        // Sampling rate of a signal, smoothed as samples arrive
+        lua.set_function("get_signal_rate", [this](const std::string& name) -> sol::object {
+            if (currentSignalRegistry == nullptr) {
+                return sol::lua_nil;
             }
 
-            return result;
+            const Signal* sig = currentSignalRegistry->Find(name);
+            if (sig == nullptr) {
+                return sol::lua_nil;
+            }
+
+            SampleRateEstimate rate = sig->Rate();
+            if (!rate.Valid()) {
+                return sol::lua_nil;
+            }
+            sol::table result = lua.create_table();
+            result.set("rate", rate.Frequency());
+            result.set("dt", rate.dt);
+            result.set("jitter", rate.Jitter());
+            result.set("last_gap", rate.lastGap);
+            result.set("max_gap", rate.maxGap);
+            result.set("regular", rate.IsRegular());
+            return sol::make_object(lua, result);
         });
 
         // Function to check if a signal exists
@@ -1092,45 +1124,28 @@ private:
             if (currentSignalRegistry == nullptr) {
                 return false;
             }
-            return currentSignalRegistry->find(name) != currentSignalRegistry->end();
+            return currentSignalRegistry->Contains(name);
         });
 
         // Optimization: Fast Signal Access API
-        // Get integer ID for a signal name (creates signal if needed)
+        // Get the registry handle for a signal name (creates signal if needed).
+        // Handles stay valid across clear_all_signals.
         lua.set_function("get_signal_id", [this](const std::string& name) -> int {
-            // Check cache first
-            auto it = signalNameCache.find(name);
-            if (it != signalNameCache.end()) {
-                return it->second;
-            }
-
-            // Not in cache, get from registry
-            std::map<std::string, Signal>* registry = currentSignalRegistry ? currentSignalRegistry : defaultSignalRegistry;
+            SignalRegistry* registry = currentSignalRegistry ? currentSignalRegistry : defaultSignalRegistry;
             if (!registry) {
                 printf("[Lua] Error: get_signal_id('%s') failed - no registry found\n", name.c_str());
                 return -1;
             }
 
-            // Find or create in registry
-            if (registry->find(name) == registry->end()) {
-                 (*registry)[name] = Signal(name, 10000, defaultSignalMode);
-                 // printf("[Lua] Registered new signal in registry: %s\n", name.c_str());
-            }
-
-            // Add to cache
-            Signal* sigPtr = &(*registry)[name];
-            int id = static_cast<int>(signalCache.size());
-            signalCache.push_back(sigPtr);
-            signalNameCache[name] = id;
-            
-            // printf("[Lua] Cached signal ID: %s -> %d\n", name.c_str(), id);
-            return id;
+            SignalHandle handle = registry->Register(name, 10000, defaultSignalMode);
+            return handle == kInvalidSignalHandle ? -1 : static_cast<int>(handle);
         });
 
         // Update signal using fast ID access (O(1))
         lua.set_function("update_signal_fast", [this](int id, double timestamp, double value) {
-            if (id >= 0 && id < (int)signalCache.size()) {
-                Signal* sig = signalCache[id];
+            SignalRegistry* registry = currentSignalRegistry ? currentSignalRegistry : defaultSignalRegistry;
+            Signal* sig = (registry && id >= 0) ? registry->Get(static_cast<SignalHandle>(id)) : nullptr;
+            if (sig) {
                 
                 // Debug: Log the first update for this signal to confirm pipeline is working
                 static std::unordered_set<int> firstUpdateLogged;
@@ -1145,8 +1160,8 @@ private:
                 // Only log if not -1 (which is returned on error) to avoid spam
                 static int spamCounter = 0;
                 if (spamCounter++ % 1000 == 0) {
-                    printf("[Lua] Warning: update_signal_fast received invalid ID %d (cache size %zu)\n", 
-                           id, signalCache.size());
+                    printf("[Lua] Warning: update_signal_fast received invalid ID %d (registry size %zu)\n",
+                           id, registry ? registry->Count() : (size_t)0);
                 }
             }
         });
@@ -1175,20 +1190,14 @@ private:
 
         // Get current time from any signal (use the latest timestamp available)
         double currentTime = 0.0;
-        for (const auto& [name, sig] : *currentSignalRegistry) {
-            if (!sig.dataX.empty()) {
-                double lastTime;
-                if (sig.mode == PlaybackMode::ONLINE && sig.dataX.size() >= sig.maxSize) {
-                    int latestIndex = (sig.offset - 1 + sig.maxSize) % sig.maxSize;
-                    lastTime = sig.dataX[latestIndex];
-                } else {
-                    lastTime = sig.dataX.back();
-                }
+        currentSignalRegistry->ForEach([&](const Signal& sig) {
+            if (!sig.Empty()) {
+                double lastTime = sig.LatestX();
                 if (lastTime > currentTime) {
                     currentTime = lastTime;
                 }
             }
-        }
+        });
 
         // Check each alert
         for (auto& alert : alerts) {
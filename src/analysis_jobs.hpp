@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "worker_pool.hpp"
+
+// -------------------------------------------------------------------------
+// ANALYSIS JOBS
+// -------------------------------------------------------------------------
+// Histogram, FFT and spectrogram updates run on background threads instead
+// of inside the window's Render* call, which holds stateMutex (and with it
+// ingest) for the whole frame.
+//
+// Each analysis window owns an AnalysisSlot holding two jobs. The UI thread
+// fills the back job with a snapshot of the window's parameters and copies
+// of the samples it needs (workers never touch a Signal, whose offline
+// storage isn't thread-safe) and submits it. An analysis thread runs it, and
+// a later frame's Collect() swaps it to the front. The window always draws
+// the front job's results, so it never waits on a computation; at most one
+// job per window is in flight, and a window that wants an update while one
+// is running simply asks again next frame.
+//
+// Jobs may split their work further with GetWorkerPool().ParallelFor.
+
+class AnalysisJobs {
+public:
+  explicit AnalysisJobs(size_t threads) {
+    for (size_t i = 0; i < std::max<size_t>(threads, 1); i++) {
+      threadsList.emplace_back([this] { ThreadLoop(); });
+    }
+  }
+
+  AnalysisJobs(const AnalysisJobs&) = delete;
+  AnalysisJobs& operator=(const AnalysisJobs&) = delete;
+
+  ~AnalysisJobs() { Stop(); }
+
+  void Submit(std::function<void()> job) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (stopping) return;
+      queue.push_back(std::move(job));
+    }
+    cv.notify_one();
+  }
+
+  // Jobs queued or running
+  size_t Pending() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queue.size() + running;
+  }
+
+  // Jobs finished since startup (frame pacing redraws when this moves)
+  uint64_t Completed() const { return completed.load(std::memory_order_acquire); }
+
+  // Drop queued jobs and wait for running ones (before tearing down the
+  // caches jobs use)
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (stopping && threadsList.empty()) return;
+      stopping = true;
+      queue.clear();
+    }
+    cv.notify_all();
+    for (auto& t : threadsList) t.join();
+    threadsList.clear();
+  }
+
+private:
+  void ThreadLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+      cv.wait(lock, [&] { return stopping || !queue.empty(); });
+      if (stopping) return;
+      std::function<void()> job = std::move(queue.front());
+      queue.pop_front();
+      running++;
+      lock.unlock();
+      job();
+      job = nullptr; // Release captured state outside the lock
+      completed.fetch_add(1, std::memory_order_release);
+      lock.lock();
+      running--;
+    }
+  }
+
+  std::vector<std::thread> threadsList;
+  mutable std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::function<void()>> queue;
+  size_t running = 0;
+  bool stopping = false;
+  std::atomic<uint64_t> completed{0};
+};
+
+inline AnalysisJobs& GetAnalysisJobs() {
+  GetWorkerPool(); // Constructed first so it outlives the analysis threads
+  static AnalysisJobs jobs(std::min(2u, std::max(1u, std::thread::hardware_concurrency() / 2)));
+  return jobs;
+}
+
+// Double-buffered job of one analysis window. Job is a plain struct of
+// inputs and results with a Bytes() method; State is scratch that persists
+// across jobs (FFT buffers, running bin counts) and belongs to whichever
+// thread owns the slot at the moment: the worker while Busy(), the UI
+// thread otherwise.
+//
+// All methods are for the UI thread. Copying a window gives the copy an
+// empty slot (it recomputes on its next frame), never a shared one.
+template <typename Job, typename State>
+class AnalysisSlot {
+public:
+  AnalysisSlot() = default;
+  AnalysisSlot(const AnalysisSlot&) {}
+  AnalysisSlot(AnalysisSlot&&) noexcept = default;
+  AnalysisSlot& operator=(const AnalysisSlot& other) {
+    if (this != &other) {
+      shared.reset();
+      front = 0;
+      busy = false;
+    }
+    return *this;
+  }
+  AnalysisSlot& operator=(AnalysisSlot&&) noexcept = default;
+
+  // A submitted job hasn't been collected yet
+  bool Busy() const { return busy; }
+
+  // The job to fill before Submit(); only valid while !Busy()
+  Job& Next() { return Shared().jobs[1 - front]; }
+
+  // Worker-side scratch; only valid while !Busy()
+  State& Scratch() { return Shared().state; }
+
+  // Run fn(Next(), Scratch()) on an analysis thread
+  template <typename Fn>
+  void Submit(Fn fn) {
+    std::shared_ptr<SharedState> s = sharedPtr();
+    int back = 1 - front;
+    s->done.store(false, std::memory_order_relaxed);
+    busy = true;
+    GetAnalysisJobs().Submit([s, back, fn]() {
+      fn(s->jobs[back], s->state);
+      s->workerBytes.store(s->jobs[back].Bytes() + s->state.Bytes(), std::memory_order_relaxed);
+      s->done.store(true, std::memory_order_release);
+    });
+  }
+
+  // Make a finished job the front one. True once per completed job.
+  bool Collect() {
+    if (!busy || !shared || !shared->done.load(std::memory_order_acquire)) return false;
+    front = 1 - front;
+    busy = false;
+    return true;
+  }
+
+  // Last collected job (default-constructed until the first completes)
+  const Job& Latest() const { return shared ? shared->jobs[front] : empty; }
+  Job& Latest() { return Shared().jobs[front]; }
+
+  size_t Bytes() const {
+    if (!shared) return 0;
+    return shared->jobs[front].Bytes() + shared->workerBytes.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct SharedState {
+    Job jobs[2];
+    State state;
+    std::atomic<bool> done{false};
+    std::atomic<size_t> workerBytes{0}; // Back job + scratch, as of the last run
+  };
+
+  SharedState& Shared() { return *sharedPtr(); }
+  std::shared_ptr<SharedState>& sharedPtr() {
+    if (!shared) shared = std::make_shared<SharedState>();
+    return shared;
+  }
+
+  std::shared_ptr<SharedState> shared;
+  int front = 0;
+  bool busy = false;
+  inline static const Job empty{};
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "pffft.h"
+
+// -------------------------------------------------------------------------
+// FFT WORKSPACE
+// -------------------------------------------------------------------------
+// pffft wants its input, output and work arrays SIMD-aligned, which
+// std::vector doesn't guarantee. Each FFT/spectrogram window keeps one set,
+// sized for its current transform and reused every time it recomputes, so
+// the hot path never allocates.
+//
+// The buffers are scratch space, not state: copying a window (layout load,
+// vector growth) gives the copy empty buffers that it allocates on its next
+// transform, and never a second owner of the same memory.
+
+class AlignedFloatBuffer {
+public:
+  AlignedFloatBuffer() = default;
+  AlignedFloatBuffer(const AlignedFloatBuffer&) {}
+  AlignedFloatBuffer(AlignedFloatBuffer&& other) noexcept
+      : ptr(std::exchange(other.ptr, nullptr)), count(std::exchange(other.count, 0)) {}
+  AlignedFloatBuffer& operator=(const AlignedFloatBuffer& other) {
+    if (this != &other) Release();
+    return *this;
+  }
+  AlignedFloatBuffer& operator=(AlignedFloatBuffer&& other) noexcept {
+    if (this != &other) {
+      Release();
+      ptr = std::exchange(other.ptr, nullptr);
+      count = std::exchange(other.count, 0);
+    }
+    return *this;
+  }
+  ~AlignedFloatBuffer() { Release(); }
+
+  // Make room for n floats; contents are undefined after a size change
+  void Resize(size_t n) {
+    if (n == count) return;
+    Release();
+    if (n > 0) {
+      ptr = static_cast<float*>(pffft_aligned_malloc(n * sizeof(float)));
+      count = ptr ? n : 0;
+    }
+  }
+
+  void Release() {
+    if (ptr) pffft_aligned_free(ptr);
+    ptr = nullptr;
+    count = 0;
+  }
+
+  float* Data() { return ptr; }
+  const float* Data() const { return ptr; }
+  size_t Size() const { return count; }
+  float& operator[](size_t i) { return ptr[i]; }
+
+private:
+  float* ptr = nullptr;
+  size_t count = 0;
+};
+
+// Buffers for one real forward transform of size N
+struct FFTWorkspace {
+  AlignedFloatBuffer input;
+  AlignedFloatBuffer output;
+  AlignedFloatBuffer work;
+  std::vector<float> magnitudes; // N / 2 bins
+
+  // Size everything for an N-point transform (no-op if already sized);
+  // false if the aligned allocation failed
+  bool Prepare(int N) {
+    size_t n = (size_t)N;
+    input.Resize(n);
+    output.Resize(n);
+    work.Resize(n);
+    magnitudes.resize(n / 2);
+    return input.Size() == n && output.Size() == n && work.Size() == n;
+  }
+
+  size_t Bytes() const {
+    return (input.Size() + output.Size() + work.Size()) * sizeof(float) +
+           magnitudes.capacity() * sizeof(float);
+  }
+};
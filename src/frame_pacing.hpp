@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+// -------------------------------------------------------------------------
+// FRAME PACING
+// -------------------------------------------------------------------------
+// The main loop runs ingest and rendering at separate rates. Lua frame
+// callbacks (where the data sources poll their sockets) run on an ingest
+// tick of ingestHz, while a full ImGui frame is only built and presented
+// when something on screen may have changed:
+//   - user input, plus a few frames after it so ImGui can settle hovers,
+//     popups and window moves
+//   - new samples in a signal shown by a visible, unpaused window
+//   - a finished analysis job, or a deferred analysis update granted a turn
+//     in the next frame's budget (frame_scheduler.hpp; windows only ask
+//     when they have an update pending)
+//   - a pending layout load
+// and never more often than maxFps. A slow idle heartbeat (idleFps) covers
+// everything else (Lua-driven labels, throttled FFT updates). When nothing
+// is arriving the loop sleeps in SDL_WaitEventTimeout between ingest ticks.
+//
+// Vsync is off by default: maxFps already caps rendering, and a swap that
+// waits for the display would hold up the next ingest tick.
+
+class FramePacer {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  // Settings (edited from the Memory Profiler)
+  bool renderOnDemand = true; // Off: render every ingest tick, up to maxFps
+  int maxFps = 60;
+  int idleFps = 2;            // Heartbeat while nothing changes
+  int ingestHz = 60;          // Lua frame callbacks per second
+  bool vsync = false;
+
+  // Statistics (last full second)
+  double renderRate = 0.0;
+  double ingestRate = 0.0;
+
+  static constexpr int kInputFrames = 3;        // Frames rendered after each input event
+  static constexpr int kHousekeepingHz = 60;    // Memory budget / epoch collection between frames
+  static constexpr int kMaxWaitMs = 100;
+
+  // An input event arrived
+  void OnInput() { inputFrames = kInputFrames; }
+
+  // Build a frame now? `changed`: something shown may differ from the last frame
+  bool ShouldRender(bool changed) const {
+    Clock::time_point now = Clock::now();
+    if (now - lastRender < Interval(maxFps)) return false;
+    if (!renderOnDemand || changed || inputFrames > 0) return true;
+    return now - lastRender >= Interval(idleFps);
+  }
+
+  // Run the frame callbacks without a frame?
+  bool IngestDue() const { return Clock::now() - lastTick >= Interval(ingestHz); }
+
+  // Run the memory budget and epoch collection without a frame?
+  bool HousekeepingDue() const { return Clock::now() - lastHousekeeping >= Interval(kHousekeepingHz); }
+
+  // How long the loop may block waiting for input before the next ingest
+  // tick or due frame
+  int WaitTimeoutMs(bool changed) const {
+    bool wantFrame = !renderOnDemand || changed || inputFrames > 0;
+    Clock::time_point wake = std::min(lastTick + Interval(ingestHz),
+                                      lastRender + Interval(wantFrame ? maxFps : idleFps));
+    auto wait = std::chrono::ceil<std::chrono::milliseconds>(wake - Clock::now()).count();
+    return (int)std::clamp<int64_t>(wait, 0, kMaxWaitMs);
+  }
+
+  // A frame was rendered (its frame callbacks count as an ingest tick)
+  void Rendered() {
+    Clock::time_point now = Clock::now();
+    lastRender = lastTick = lastHousekeeping = now;
+    if (inputFrames > 0) inputFrames--;
+    frames++;
+    ticks++;
+    UpdateRates(now);
+  }
+
+  // Frame callbacks ran without a frame
+  void Ticked(bool housekeeping) {
+    Clock::time_point now = Clock::now();
+    lastTick = now;
+    if (housekeeping) lastHousekeeping = now;
+    ticks++;
+    UpdateRates(now);
+  }
+
+private:
+  static Clock::duration Interval(int perSecond) {
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / std::max(perSecond, 1);
+  }
+
+  void UpdateRates(Clock::time_point now) {
+    std::chrono::duration<double> elapsed = now - rateStart;
+    if (elapsed.count() < 1.0) return;
+    renderRate = frames / elapsed.count();
+    ingestRate = ticks / elapsed.count();
+    frames = ticks = 0;
+    rateStart = now;
+  }
+
+  Clock::time_point lastRender{};
+  Clock::time_point lastTick{};
+  Clock::time_point lastHousekeeping{};
+  Clock::time_point rateStart = Clock::now();
+  int inputFrames = kInputFrames;
+  uint64_t frames = 0;
+  uint64_t ticks = 0;
+};
+
+inline FramePacer& GetFramePacer() {
+  static FramePacer pacer;
+  return pacer;
+}
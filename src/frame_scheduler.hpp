@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// -------------------------------------------------------------------------
+// FRAME BUDGET SCHEDULER
+// -------------------------------------------------------------------------
+// Histogram, FFT and spectrogram windows ask the scheduler before starting
+// an update, so ten spectrograms whose throttles expire together don't all
+// recompute in the same frame. They only ask once they know there is work
+// (settings, data or the planned range changed); an idle window never
+// competes for the budget.
+//
+// Each window's update cost is the UI-thread time it takes (preparing the
+// job, applying its result; measured and smoothed), and every frame may
+// start at most budgetMs of it. The job's compute time on an analysis thread
+// is not charged: it doesn't delay the frame, and each window already keeps
+// at most one job in flight (analysis_jobs.hpp), which bounds its
+// throughput. A window that doesn't fit is deferred; at the end of the
+// frame the deferred windows are granted the next frame's budget in order
+// of priority: focused window first, then the one that has waited longest
+// (round-robin). At least one is granted per frame, so a window costlier
+// than the whole budget still updates.
+//
+// Windows that can't be seen (collapsed, hidden dock tab, off-screen or
+// fully covered) don't ask at all; they catch up once visible again.
+
+// Identifies one window across frames (its vector slot can move)
+enum class ScheduledKind : uint32_t { Histogram, FFT, Spectrogram };
+
+inline uint64_t ScheduleKey(ScheduledKind kind, int id) {
+  return ((uint64_t)kind << 32) | (uint32_t)id;
+}
+
+inline double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+class FrameScheduler {
+public:
+  // Settings (edited from the Memory Profiler)
+  bool enabled = true;
+  float budgetMs = 4.0f; // Analysis work started per frame
+
+  // Statistics (last completed frame)
+  double frameMs = 0.0;   // UI frame time, stateMutex held
+  double startedMs = 0.0; // Estimated cost of the updates started
+  int started = 0;
+  int deferred = 0;       // Windows that wanted an update and had to wait
+  int hidden = 0;         // Windows not updated because they can't be seen
+  int granted = 0;        // Deferred windows holding a turn in the next frame
+
+  static constexpr double kSmoothing = 0.2;     // Weight of a new cost sample
+  static constexpr uint64_t kForgetFrames = 600; // Drop windows not seen for this long
+
+  void BeginFrame() {
+    frameStart = std::chrono::steady_clock::now();
+    startedMs = 0.0;
+    started = deferred = hidden = 0;
+  }
+
+  // A visible window wants to start an update. True if it may this frame;
+  // otherwise it is queued for a later one.
+  bool Request(uint64_t key, bool focused) {
+    Entry& e = entries[key];
+    e.lastSeen = frame;
+    double cost = e.Cost();
+    bool allowed = !enabled;
+    if (e.grantFrame == frame) {
+      allowed = true; // Budget reserved by the last EndFrame
+    } else if (!allowed && spentMs + cost <= budgetMs) {
+      spentMs += cost;
+      allowed = true;
+    }
+    if (!allowed) {
+      e.waiting = true;
+      e.focused = focused;
+      deferred++;
+      return false;
+    }
+    e.grantFrame = 0;
+    e.waiting = false;
+    e.lastUpdate = frame;
+    startedMs += cost;
+    started++;
+    return true;
+  }
+
+  // A window that can't be seen skipped its update
+  void Hidden(uint64_t key) {
+    entries[key].lastSeen = frame;
+    hidden++;
+  }
+
+  // Measured UI-thread time of starting an update (planning, copying)
+  void RecordPrep(uint64_t key, double ms) { Smooth(entries[key].prepMs, ms); }
+
+  // Measured UI-thread time of applying a collected job's result
+  void RecordApply(uint64_t key, double ms) { Smooth(entries[key].applyMs, ms); }
+
+  double CostMs(uint64_t key) const {
+    auto it = entries.find(key);
+    return it != entries.end() ? it->second.Cost() : 0.0;
+  }
+
+  // Grant the next frame's budget to the deferred windows
+  void EndFrame() {
+    frameMs = MillisecondsSince(frameStart);
+    frame++;
+
+    waitingScratch.clear();
+    for (auto it = entries.begin(); it != entries.end();) {
+      if (it->second.lastSeen + kForgetFrames < frame) {
+        it = entries.erase(it);
+        continue;
+      }
+      if (it->second.waiting) waitingScratch.push_back(&it->second);
+      ++it;
+    }
+    std::sort(waitingScratch.begin(), waitingScratch.end(), [](const Entry* a, const Entry* b) {
+      if (a->focused != b->focused) return a->focused;
+      return a->lastUpdate < b->lastUpdate;
+    });
+
+    spentMs = 0.0;
+    granted = 0;
+    for (Entry* e : waitingScratch) {
+      e->waiting = false;
+      double cost = e->Cost();
+      if (spentMs > 0.0 && spentMs + cost > budgetMs) continue;
+      e->grantFrame = frame;
+      spentMs += std::max(cost, 1e-6);
+      granted++;
+    }
+  }
+
+private:
+  struct Entry {
+    double prepMs = 0.0;
+    double applyMs = 0.0;
+    uint64_t lastSeen = 0;
+    uint64_t lastUpdate = 0;
+    uint64_t grantFrame = 0;
+    bool waiting = false;
+    bool focused = false;
+
+    double Cost() const { return prepMs + applyMs; }
+  };
+
+  static void Smooth(double& value, double sample) {
+    value = value == 0.0 ? sample : value + kSmoothing * (sample - value);
+  }
+
+  std::unordered_map<uint64_t, Entry> entries;
+  std::vector<Entry*> waitingScratch;
+  uint64_t frame = 1;
+  double spentMs = 0.0; // Budget used (or reserved by grants) this frame
+  std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+};
+
+inline FrameScheduler& GetFrameScheduler() {
+  static FrameScheduler scheduler;
+  return scheduler;
+}
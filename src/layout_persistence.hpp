@@ -5,6 +5,7 @@
 #include "LuaScriptManager.hpp"
 // Note: Offline playback is now handled by Lua (scripts/io/DataSource.lua)
 // The LoadLogFile function below is deprecated and kept for compatibility only
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
@@ -133,6 +134,8 @@ inline bool SaveLayout(const std::string &filename,
       out << YAML::Key << "paused" << YAML::Value << xyPlot.paused;
       out << YAML::Key << "xSignal" << YAML::Value << xyPlot.xSignalName;
       out << YAML::Key << "ySignal" << YAML::Value << xyPlot.ySignalName;
+      out << YAML::Key << "join" << YAML::Value << JoinModeName(xyPlot.joinMode);
+      out << YAML::Key << "trailLength" << YAML::Value << xyPlot.maxHistorySize;
       out << YAML::EndMap;
     }
     out << YAML::EndSeq;
@@ -157,8 +160,12 @@ inline bool SaveLayout(const std::string &filename,
       out << YAML::Key << "title" << YAML::Value << fft.title;
       out << YAML::Key << "signal" << YAML::Value << fft.signalName;
       out << YAML::Key << "fftSize" << YAML::Value << fft.fftSize;
-      out << YAML::Key << "useHanning" << YAML::Value << fft.useHanning;
+      out << YAML::Key << "window" << YAML::Value << WindowTypeName(fft.window);
+      out << YAML::Key << "useHanning" << YAML::Value << (fft.window != WindowType::Rectangular); // Older builds
       out << YAML::Key << "logScale" << YAML::Value << fft.logScale;
+      out << YAML::Key << "welch" << YAML::Value << fft.welch;
+      out << YAML::Key << "welchOverlap" << YAML::Value << fft.welchOverlap;
+      out << YAML::Key << "parallel" << YAML::Value << fft.parallel;
       out << YAML::EndMap;
     }
     out << YAML::EndSeq;
@@ -172,10 +179,17 @@ inline bool SaveLayout(const std::string &filename,
       out << YAML::Key << "signal" << YAML::Value << spectrogram.signalName;
       out << YAML::Key << "fftSize" << YAML::Value << spectrogram.fftSize;
       out << YAML::Key << "hopSize" << YAML::Value << spectrogram.hopSize;
-      out << YAML::Key << "useHanning" << YAML::Value << spectrogram.useHanning;
+      out << YAML::Key << "window" << YAML::Value << WindowTypeName(spectrogram.window);
+      out << YAML::Key << "useHanning" << YAML::Value << (spectrogram.window != WindowType::Rectangular); // Older builds
       out << YAML::Key << "logScale" << YAML::Value << spectrogram.logScale;
       out << YAML::Key << "timeWindow" << YAML::Value << spectrogram.timeWindow;
       out << YAML::Key << "maxFrequency" << YAML::Value << spectrogram.maxFrequency;
+      out << YAML::Key << "parallel" << YAML::Value << spectrogram.parallel;
+      out << YAML::Key << "range" << YAML::Value << SpectrogramRangeName(spectrogram.rangeMode);
+      out << YAML::Key << "fixedMin" << YAML::Value << spectrogram.fixedMin;
+      out << YAML::Key << "fixedMax" << YAML::Value << spectrogram.fixedMax;
+      out << YAML::Key << "percentileLow" << YAML::Value << spectrogram.percentileLow;
+      out << YAML::Key << "percentileHigh" << YAML::Value << spectrogram.percentileHigh;
       out << YAML::EndMap;
     }
     out << YAML::EndSeq;
@@ -232,6 +246,14 @@ inline bool SaveLayout(const std::string &filename,
   }
 }
 
+// FFT/spectrogram window function; layouts from before the window choice only
+// have useHanning (true = Hann, false = rectangular)
+inline WindowType LoadWindowType(const YAML::Node &node) {
+  if (node["window"]) return WindowTypeFromName(node["window"].as<std::string>());
+  if (node["useHanning"] && !node["useHanning"].as<bool>()) return WindowType::Rectangular;
+  return WindowType::Hann;
+}
+
 inline bool LoadLayout(const std::string &filename, LayoutData& data) {
   try {
     YAML::Node config = YAML::LoadFile(filename);
@@ -308,6 +330,8 @@ inline bool LoadLayout(const std::string &filename, LayoutData& data) {
         xyPlot.paused = xyPlotNode["paused"] ? xyPlotNode["paused"].as<bool>() : false;
         xyPlot.xSignalName = xyPlotNode["xSignal"] ? xyPlotNode["xSignal"].as<std::string>() : "";
         xyPlot.ySignalName = xyPlotNode["ySignal"] ? xyPlotNode["ySignal"].as<std::string>() : "";
+        xyPlot.joinMode = xyPlotNode["join"] ? JoinModeFromName(xyPlotNode["join"].as<std::string>()) : JoinMode::Linear;
+        xyPlot.maxHistorySize = xyPlotNode["trailLength"] ? std::max(2, xyPlotNode["trailLength"].as<int>()) : 500;
         xyPlot.isOpen = true;
 
 
@@ -346,8 +370,11 @@ inline bool LoadLayout(const std::string &filename, LayoutData& data) {
         fft.title = fftNode["title"].as<std::string>();
         fft.signalName = fftNode["signal"] ? fftNode["signal"].as<std::string>() : "";
         fft.fftSize = fftNode["fftSize"] ? fftNode["fftSize"].as<int>() : 2048;
-        fft.useHanning = fftNode["useHanning"] ? fftNode["useHanning"].as<bool>() : true;
+        fft.window = LoadWindowType(fftNode);
         fft.logScale = fftNode["logScale"] ? fftNode["logScale"].as<bool>() : true;
+        fft.welch = fftNode["welch"] ? fftNode["welch"].as<bool>() : false;
+        fft.welchOverlap = fftNode["welchOverlap"] ? fftNode["welchOverlap"].as<float>() : 0.5f;
+        fft.parallel = fftNode["parallel"] ? fftNode["parallel"].as<bool>() : true;
         fft.isOpen = true;
 
 
@@ -368,10 +395,16 @@ inline bool LoadLayout(const std::string &filename, LayoutData& data) {
         spectrogram.signalName = spectrogramNode["signal"] ? spectrogramNode["signal"].as<std::string>() : "";
         spectrogram.fftSize = spectrogramNode["fftSize"] ? spectrogramNode["fftSize"].as<int>() : 512;
         spectrogram.hopSize = spectrogramNode["hopSize"] ? spectrogramNode["hopSize"].as<int>() : 128;
-        spectrogram.useHanning = spectrogramNode["useHanning"] ? spectrogramNode["useHanning"].as<bool>() : true;
+        spectrogram.window = LoadWindowType(spectrogramNode);
         spectrogram.logScale = spectrogramNode["logScale"] ? spectrogramNode["logScale"].as<bool>() : true;
         spectrogram.timeWindow = spectrogramNode["timeWindow"] ? spectrogramNode["timeWindow"].as<double>() : 5.0;
         spectrogram.maxFrequency = spectrogramNode["maxFrequency"] ? spectrogramNode["maxFrequency"].as<int>() : 0;
+        spectrogram.parallel = spectrogramNode["parallel"] ? spectrogramNode["parallel"].as<bool>() : true;
+        spectrogram.rangeMode = SpectrogramRangeFromName(spectrogramNode["range"] ? spectrogramNode["range"].as<std::string>() : "auto");
+        spectrogram.fixedMin = spectrogramNode["fixedMin"] ? spectrogramNode["fixedMin"].as<float>() : -120.0f;
+        spectrogram.fixedMax = spectrogramNode["fixedMax"] ? spectrogramNode["fixedMax"].as<float>() : 0.0f;
+        spectrogram.percentileLow = spectrogramNode["percentileLow"] ? spectrogramNode["percentileLow"].as<float>() : 5.0f;
+        spectrogram.percentileHigh = spectrogramNode["percentileHigh"] ? spectrogramNode["percentileHigh"].as<float>() : 99.5f;
         spectrogram.isOpen = true;
 
 
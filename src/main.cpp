@@ -35,9 +35,11 @@
 #include <ShellScalingApi.h>
 
 #include "types.hpp"
+#include "signal_registry.hpp"
 #include "LuaScriptManager.hpp"
 #include "plot_types.hpp"
 #include "signal_processing.hpp"
+#include "signal_budget.hpp"
 #include "ui_state.hpp"
 
 // Note: plot_rendering.hpp is included later, after global state definitions
@@ -66,8 +68,8 @@ struct OfflinePlaybackState {
   std::string loadedFilePath;
 } offlineState;
 
-// The Registry: Maps a string ID to the actual data buffer
-std::map<std::string, Signal> signalRegistry;
+// The Registry: signal names -> stable handles -> data buffers
+SignalRegistry signalRegistry;
 
 // Lua Script Manager
 LuaScriptManager luaScriptManager;
@@ -92,7 +94,8 @@ static auto lastFrameTime = std::chrono::high_resolution_clock::now();
 // NETWORK HANDLING
 // -------------------------------------------------------------------------
 // All network I/O is now handled in Lua via scripts/io/UDPDataSink.lua
-// which runs as an on_frame() callback at ~60 FPS with non-blocking sockets.
+// which runs as an on_frame() callback on the ingest tick (see frame_pacing.hpp)
+// with non-blocking sockets.
 // This eliminates the need for a separate C++ network thread.
 
 //
@@ -138,6 +141,82 @@ struct GlobalContext {
   SDL_GLContext gl_context;
 };
 
+// Frame pacing (see frame_pacing.hpp)
+static bool contentChanged = true;        // Something on screen may differ from the last frame
+static uint64_t renderedDataVersion = 0;  // VisibleDataVersion() as of the last frame
+static uint64_t renderedJobs = 0;         // Analysis jobs finished before the last frame
+
+// Changes whenever a signal shown by a visible window gets new samples or is
+// reset. Caller holds stateMutex.
+static uint64_t VisibleDataVersion() {
+  uint64_t version = 0;
+  for (const auto& name : uiPlotState.visibleSignals) {
+    if (const Signal* sig = signalRegistry.Find(name)) {
+      version = version * 1099511628211ull + sig->totalCount + ((uint64_t)sig->generation << 40);
+    }
+  }
+  return version;
+}
+
+// Caller holds stateMutex
+static bool FrameContentChanged() {
+  return VisibleDataVersion() != renderedDataVersion ||
+         GetAnalysisJobs().Completed() != renderedJobs ||
+         GetFrameScheduler().granted > 0 ||
+         !uiPlotState.pendingLoadFilename.empty();
+}
+
+// Tier 3: Execute frame callbacks. Runs once per ingest tick, whether or not
+// that tick renders a frame. Caller holds stateMutex.
+static void RunFrameCallbacks() {
+  frameNumber++;
+  auto currentFrameTime = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> elapsed = currentFrameTime - lastFrameTime;
+  double deltaTime = elapsed.count();
+  lastFrameTime = currentFrameTime;
+
+  // Count total active plots
+  int totalPlots = (int)(uiPlotState.activePlots.size() +
+                        uiPlotState.activeReadoutBoxes.size() +
+                        uiPlotState.activeXYPlots.size() +
+                        uiPlotState.activeHistograms.size() +
+                        uiPlotState.activeFFTs.size() +
+                        uiPlotState.activeSpectrograms.size());
+
+  luaScriptManager.executeFrameCallbacks(signalRegistry, frameNumber, deltaTime, totalPlots, &uiPlotState);
+  uiPlotState.consumeControlEvents();
+}
+
+// Caller holds stateMutex
+static void RunHousekeeping() {
+  // Keep signal storage within the global memory budget
+  {
+    std::lock_guard<std::mutex> activeLock(uiPlotState.activeSignalsMutex);
+    GetSignalMemoryBudget().Enforce(signalRegistry, uiPlotState.activeSignals);
+  }
+
+  // Return signal storage retired since the last call once lock-free readers are done with it
+  GetSignalEpochs().Collect();
+}
+
+// Ingest tick between frames: frame callbacks without building a frame
+void IngestStep() {
+  if (!appRunning) {
+    return;
+  }
+
+  FramePacer& pacer = GetFramePacer();
+  std::lock_guard<std::mutex> lock(stateMutex);
+  RunFrameCallbacks();
+
+  // Budget enforcement paces its work per call, so keep it near the frame rate
+  bool housekeeping = pacer.HousekeepingDue();
+  if (housekeeping) RunHousekeeping();
+
+  contentChanged = FrameContentChanged();
+  pacer.Ticked(housekeeping);
+}
+
 void MainLoopStep(void *arg) {
   GlobalContext *ctx = (GlobalContext *)arg;
   ImGuiIO &io = ImGui::GetIO();
@@ -189,23 +268,10 @@ void MainLoopStep(void *arg) {
 
   // Lock data while we render to prevent iterator invalidation
   std::lock_guard<std::mutex> lock(stateMutex);
+  GetFrameScheduler().BeginFrame();
+  renderedJobs = GetAnalysisJobs().Completed();
 
-  // Tier 3: Execute frame callbacks
-  frameNumber++;
-  auto currentFrameTime = std::chrono::high_resolution_clock::now();
-  std::chrono::duration<double> elapsed = currentFrameTime - lastFrameTime;
-  double deltaTime = elapsed.count();
-  lastFrameTime = currentFrameTime;
-
-  // Count total active plots
-  int totalPlots = (int)(uiPlotState.activePlots.size() +
-                        uiPlotState.activeReadoutBoxes.size() +
-                        uiPlotState.activeXYPlots.size() +
-                        uiPlotState.activeHistograms.size() +
-                        uiPlotState.activeFFTs.size() +
-                        uiPlotState.activeSpectrograms.size());
-
-  luaScriptManager.executeFrameCallbacks(signalRegistry, frameNumber, deltaTime, totalPlots, &uiPlotState);
+  RunFrameCallbacks();
 
   // Get menu bar height
   float menuBarHeight = ImGui::GetFrameHeight();
@@ -272,6 +338,9 @@ void MainLoopStep(void *arg) {
   // ---------------------------------------------------------
   RenderFileDialogs(uiPlotState);
 
+  // Analysis windows deferred this frame get the next frame's budget
+  GetFrameScheduler().EndFrame();
+
   // ---------------------------------------------------------
   // CLEANUP PHASE (The "Erase-Remove Idiom")
   // ---------------------------------------------------------
@@ -323,6 +392,13 @@ void MainLoopStep(void *arg) {
   // Update active signal set for parser optimization
   uiPlotState.refreshActiveSignals();
 
+  RunHousekeeping();
+
+  // New samples for what is on screen now wake the next frame
+  uiPlotState.refreshVisibleSignals();
+  renderedDataVersion = VisibleDataVersion();
+  contentChanged = FrameContentChanged();
+
   // Render
   ImGui::Render();
   glViewport(0, 0, (int)io.DisplaySize.x, (int)io.DisplaySize.y);
@@ -379,7 +455,9 @@ int main(int, char **) {
   }
 
   SDL_GL_MakeCurrent(window, gl_context);
-  SDL_GL_SetSwapInterval(1);
+  // Frame pacing caps the frame rate; vsync is opt-in (see frame_pacing.hpp)
+  bool vsyncEnabled = GetFramePacer().vsync;
+  SDL_GL_SetSwapInterval(vsyncEnabled ? 1 : 0);
 
   // Windows-specific hints for smoother vsync and timing
   SDL_SetHint(SDL_HINT_RENDER_VSYNC, "1");
@@ -424,25 +502,45 @@ int main(int, char **) {
   scanAvailableParsers(availableParsers);
 
   SDL_Event event;
+  FramePacer& pacer = GetFramePacer();
   while (appRunning) {
-    // Use SDL_WaitEventTimeout to reduce CPU usage when idle
-    // 16ms timeout targets ~60 FPS, allowing the OS to idle the thread
-    if (SDL_WaitEventTimeout(&event, 16)) {
+    // Sleep until input arrives, the next ingest tick is due or a pending
+    // frame is allowed by the FPS cap, letting the OS idle the thread
+    if (SDL_WaitEventTimeout(&event, pacer.WaitTimeoutMs(contentChanged))) {
       // Process the event that woke us up
       do {
         ImGui_ImplSDL2_ProcessEvent(&event);
         if (event.type == SDL_QUIT)
           appRunning = false;
       } while (SDL_PollEvent(&event)); // Drain any remaining events
+      pacer.OnInput();
+    }
+
+    // A frame runs the frame callbacks too; otherwise just ingest
+    if (pacer.ShouldRender(contentChanged)) {
+      MainLoopStep(&ctx);
+      pacer.Rendered();
+    } else if (pacer.IngestDue()) {
+      IngestStep();
     }
 
-    MainLoopStep(&ctx);
+    if (pacer.vsync != vsyncEnabled) {
+      vsyncEnabled = pacer.vsync;
+      SDL_GL_SetSwapInterval(vsyncEnabled ? 1 : 0);
+    }
   }
 
   // Tier 5: Stop all Lua I/O threads before cleanup
   printf("Stopping Lua threads...\n");
   luaScriptManager.stopAllLuaThreads();
 
+  // Let running analysis jobs finish while the FFT/window caches still exist
+  GetAnalysisJobs().Stop();
+
+  // Release signal storage while the chunk pool and epoch manager still exist
+  signalRegistry.Reset();
+  GetSignalEpochs().Drain();
+
   ImGui_ImplOpenGL3_Shutdown();
   ImGui_ImplSDL2_Shutdown();
   ImPlot::DestroyContext();
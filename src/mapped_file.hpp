@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <winioctl.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// -------------------------------------------------------------------------
+// MEMORY-MAPPED FILE
+// -------------------------------------------------------------------------
+// Maps a whole file into the address space. Pages are backed by the file
+// rather than by the page file/swap, so the OS can drop them under memory
+// pressure and fault them back in on access. Used to spill signal history
+// to disk.
+
+class MappedFile {
+public:
+  MappedFile() = default;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile() { Close(); }
+
+  // Map `bytes` bytes of `path`. With create=true the file is created (or
+  // truncated) and sized to `bytes`. With deleteOnClose=true the file
+  // disappears once the mapping is closed (or the process exits).
+  bool Open(const std::string& path, size_t bytes, bool writable, bool create, bool deleteOnClose) {
+    Close();
+    if (bytes == 0) return false;
+
+#ifdef _WIN32
+    DWORD access = GENERIC_READ | (writable ? GENERIC_WRITE : 0);
+    DWORD attributes = deleteOnClose ? (FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE)
+                                     : FILE_ATTRIBUTE_NORMAL;
+    file = CreateFileA(path.c_str(), access, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                       create ? CREATE_ALWAYS : OPEN_EXISTING, attributes, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+      printf("[MappedFile] Failed to open %s\n", path.c_str());
+      file = nullptr;
+      return false;
+    }
+    if (create) {
+      // Sparse, like ftruncate elsewhere: disk is only used for pages written
+      DWORD returned = 0;
+      DeviceIoControl(file, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &returned, nullptr);
+    }
+    uint64_t size = (uint64_t)bytes;
+    mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                 (DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFFu), nullptr);
+    if (mapping) {
+      data = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, bytes);
+    }
+#else
+    int flags = (writable ? O_RDWR : O_RDONLY) | (create ? (O_CREAT | O_TRUNC) : 0);
+    fd = open(path.c_str(), flags, 0600);
+    if (fd < 0) {
+      printf("[MappedFile] Failed to open %s\n", path.c_str());
+      return false;
+    }
+    if (create && ftruncate(fd, (off_t)bytes) != 0) {
+      printf("[MappedFile] Failed to size %s\n", path.c_str());
+      Close();
+      return false;
+    }
+    void* p = mmap(nullptr, bytes, PROT_READ | (writable ? PROT_WRITE : 0), MAP_SHARED, fd, 0);
+    data = (p == MAP_FAILED) ? nullptr : p;
+    if (deleteOnClose) unlink(path.c_str());
+#endif
+
+    if (!data) {
+      printf("[MappedFile] Failed to map %s (%zu bytes)\n", path.c_str(), bytes);
+      Close();
+      return false;
+    }
+    length = bytes;
+    return true;
+  }
+
+  void Close() {
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mapping) CloseHandle(mapping);
+    if (file) CloseHandle(file);
+    mapping = nullptr;
+    file = nullptr;
+#else
+    if (data) munmap(data, length);
+    if (fd >= 0) close(fd);
+    fd = -1;
+#endif
+    data = nullptr;
+    length = 0;
+  }
+
+  // Start writing dirty pages back without waiting for the disk
+  void FlushAsync() {
+    if (!data) return;
+#ifdef _WIN32
+    FlushViewOfFile(data, 0);
+#else
+    msync(data, length, MS_ASYNC);
+#endif
+  }
+
+  void* Data() const { return data; }
+  size_t Size() const { return length; }
+  bool IsOpen() const { return data != nullptr; }
+
+  // Per-user temp directory, with a trailing separator
+  static std::string TempDirectory() {
+#ifdef _WIN32
+    char buffer[260];
+    DWORD n = GetTempPathA(sizeof(buffer), buffer);
+    if (n > 0 && n < sizeof(buffer)) return std::string(buffer, n);
+    return ".\\";
+#else
+    const char* dir = getenv("TMPDIR");
+    std::string path = (dir && *dir) ? dir : "/tmp";
+    if (path.back() != '/') path += '/';
+    return path;
+#endif
+  }
+
+  // Unique file name in `dir` for this process
+  static std::string UniquePath(const std::string& dir, const std::string& prefix) {
+    static std::atomic<uint64_t> counter{0};
+#ifdef _WIN32
+    unsigned long pid = (unsigned long)GetCurrentProcessId();
+#else
+    unsigned long pid = (unsigned long)getpid();
+#endif
+    return dir + prefix + "_" + std::to_string(pid) + "_" + std::to_string(counter++) + ".bin";
+  }
+
+private:
+#ifdef _WIN32
+  HANDLE file = nullptr;
+  HANDLE mapping = nullptr;
+#else
+  int fd = -1;
+#endif
+  void* data = nullptr;
+  size_t length = 0;
+};
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+#include <intrin.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// -------------------------------------------------------------------------
+// MIRRORED RING STORAGE
+// -------------------------------------------------------------------------
+// Backing store for an online signal's circular buffer. The same physical
+// pages are mapped twice, back to back, so element i and i + Capacity()
+// alias each other. Any run of up to Capacity() samples starting anywhere
+// in the ring is then one contiguous array: readers use Data() + offset
+// directly instead of unwrapping with (offset + i) % size.
+//
+// A mapping covers whole pages (64 KB allocation granularity on Windows),
+// so Capacity() may exceed the samples asked for. The ring is mirrored when
+// that at most doubles it (kMaxMirrorGrowth): every ring of at least half a
+// granularity unit, e.g. the default 10000 samples (78 KB, mapped as 128 KB)
+// on Windows. Smaller rings, or any ring if the OS refuses the double
+// mapping, are a plain heap array of exactly the requested size, and runs
+// that cross the end must be split (Contiguous() is false). The memory
+// budget charges the mapped capacity (MemoryBytes).
+// The owner decides how many samples it keeps; the extra capacity is just
+// where the wrap point lies.
+//
+// Put() stores each element with a relaxed atomic store and CopyRelaxed()
+// reads with relaxed atomic loads, so a lock-free reader copying a range the
+// writer is overwriting gets a torn copy (which its seqlock check discards)
+// rather than a data race. Readers holding the writer's lock use plain reads.
+
+class MirrorRing {
+public:
+  MirrorRing() = default;
+  MirrorRing(const MirrorRing&) = delete;
+  MirrorRing& operator=(const MirrorRing&) = delete;
+
+  MirrorRing(MirrorRing&& other) noexcept { Steal(other); }
+  MirrorRing& operator=(MirrorRing&& other) noexcept {
+    if (this != &other) {
+      Release();
+      Steal(other);
+    }
+    return *this;
+  }
+
+  ~MirrorRing() { Release(); }
+
+  // Largest mapped capacity, as a multiple of the request, worth mirroring
+  static constexpr size_t kMaxMirrorGrowth = 2;
+
+  // Smallest capacity >= samples that fills whole pages
+  static size_t RoundCapacity(size_t samples) {
+    size_t page = Granularity() / sizeof(double);
+    if (samples == 0) samples = 1;
+    return (samples + page - 1) / page * page;
+  }
+
+  // (Re)allocate room for at least `samples` samples; contents are undefined.
+  // allowMirror=false forces a plain ring of exactly `samples`.
+  void Allocate(size_t samples, bool allowMirror = true) {
+    Release();
+    if (samples == 0) samples = 1;
+    size_t cap = RoundCapacity(samples);
+    void* base = nullptr;
+    if (allowMirror && cap <= samples * kMaxMirrorGrowth) {
+      base = MapTwice(cap * sizeof(double));
+      if (!base) printf("[MirrorRing] Double mapping unavailable, using a plain ring\n");
+    }
+    if (base) {
+      mirrored = true;
+    } else {
+      cap = samples;
+      base = new double[cap];
+      mirrored = false;
+    }
+    data = (double*)base;
+    capacity = cap;
+  }
+
+  void Release() {
+    if (!data) return;
+    if (mirrored) {
+      Unmap(data, capacity * sizeof(double));
+    } else {
+      delete[] data;
+    }
+    data = nullptr;
+    capacity = 0;
+  }
+
+  // Writer: store value at ring index i (0 <= i < Capacity())
+  void Put(size_t i, double value) { StoreRelaxed(data + i, value); }
+
+  // Lock-free reader: copy n elements that the writer may be overwriting
+  static void CopyRelaxed(const double* src, size_t n, double* dst) {
+    for (size_t i = 0; i < n; i++) dst[i] = LoadRelaxed(src + i);
+  }
+
+  // Mirrored: valid for indices [0, 2 * Capacity()); plain: [0, Capacity())
+  double* Data() { return data; }
+  const double* Data() const { return data; }
+
+  // Element at ring index i (0 <= i < 2 * Capacity()), wrapping if needed
+  double operator[](size_t i) const { return data[i < capacity ? i : i - capacity]; }
+
+  // Whether n elements starting at ring index start (< Capacity()) can be
+  // read straight from Data() + start
+  bool Contiguous(size_t start, size_t n) const { return mirrored || start + n <= capacity; }
+
+  size_t Capacity() const { return capacity; }
+  bool IsAllocated() const { return data != nullptr; }
+  bool IsMirrored() const { return mirrored; }
+
+  // Physical memory used (the mirror costs address space only)
+  size_t MemoryBytes() const { return capacity * sizeof(double); }
+
+private:
+  // Relaxed atomic access to a plain, naturally aligned double (C++17 has no
+  // std::atomic_ref): the compiler builtins on GCC/Clang, volatile 64-bit
+  // accesses on MSVC (what its std::atomic uses for relaxed order)
+  static void StoreRelaxed(double* p, double value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    __int64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    __iso_volatile_store64(reinterpret_cast<volatile __int64*>(p), bits);
+#else
+    __atomic_store(p, &value, __ATOMIC_RELAXED);
+#endif
+  }
+
+  static double LoadRelaxed(const double* p) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    __int64 bits = __iso_volatile_load64(reinterpret_cast<const volatile __int64*>(p));
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+#else
+    double value;
+    __atomic_load(p, &value, __ATOMIC_RELAXED);
+    return value;
+#endif
+  }
+
+  static size_t Granularity() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (size_t)info.dwAllocationGranularity;
+#else
+    long page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? (size_t)page : 4096;
+#endif
+  }
+
+  // Map one `bytes`-sized section at [base, base + bytes) and again at
+  // [base + bytes, base + 2 * bytes). Returns base or nullptr.
+  static void* MapTwice(size_t bytes) {
+#ifdef _WIN32
+    uint64_t size = (uint64_t)bytes;
+    HANDLE section = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        (DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFFu), nullptr);
+    if (!section) return nullptr;
+
+    // Find a free 2x range, release it and map both views into it. Another
+    // thread can grab the range in between, so retry a few times.
+    void* result = nullptr;
+    for (int attempt = 0; attempt < 8 && !result; attempt++) {
+      char* base = (char*)VirtualAlloc(nullptr, 2 * bytes, MEM_RESERVE, PAGE_NOACCESS);
+      if (!base) break;
+      VirtualFree(base, 0, MEM_RELEASE);
+      void* lower = MapViewOfFileEx(section, FILE_MAP_ALL_ACCESS, 0, 0, bytes, base);
+      void* upper = lower ? MapViewOfFileEx(section, FILE_MAP_ALL_ACCESS, 0, 0, bytes, base + bytes) : nullptr;
+      if (lower && upper) {
+        result = base;
+      } else if (lower) {
+        UnmapViewOfFile(lower);
+      }
+    }
+    CloseHandle(section); // The views keep the section alive
+    return result;
+#else
+    int fd = -1;
+#ifdef __linux__
+    fd = memfd_create("signakit_ring", MFD_CLOEXEC);
+#endif
+    if (fd < 0) {
+      std::string path = MappedFile::UniquePath(MappedFile::TempDirectory(), "signakit_ring");
+      fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+      if (fd >= 0) unlink(path.c_str());
+    }
+    if (fd < 0) return nullptr;
+    if (ftruncate(fd, (off_t)bytes) != 0) {
+      close(fd);
+      return nullptr;
+    }
+
+    // Reserve the 2x range, then overlay both halves with the same file
+    void* reserved = mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved == MAP_FAILED) {
+      close(fd);
+      return nullptr;
+    }
+    char* base = (char*)reserved;
+    void* lower = mmap(base, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    void* upper = mmap(base + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    close(fd); // The mappings keep the pages alive
+    if (lower == MAP_FAILED || upper == MAP_FAILED) {
+      munmap(base, 2 * bytes);
+      return nullptr;
+    }
+    return base;
+#endif
+  }
+
+  static void Unmap(double* base, size_t bytes) {
+#ifdef _WIN32
+    UnmapViewOfFile(base);
+    UnmapViewOfFile((char*)base + bytes);
+#else
+    munmap(base, 2 * bytes);
+#endif
+  }
+
+  void Steal(MirrorRing& other) {
+    data = other.data;
+    capacity = other.capacity;
+    mirrored = other.mirrored;
+    other.data = nullptr;
+    other.capacity = 0;
+  }
+
+  double* data = nullptr;
+  size_t capacity = 0;
+  bool mirrored = false;
+};
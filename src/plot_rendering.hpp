@@ -2,12 +2,21 @@
 
 #include "imgui.h"
 #include "implot.h"
+#include "implot_internal.h"
+#include "imgui_internal.h"
 #include "ImGuiFileDialog.h"
 #include "plot_types.hpp"
 #include "ui_state.hpp"
 #include "types.hpp"
+#include "signal_registry.hpp"
 #include "signal_processing.hpp"
+#include "signal_budget.hpp"
+#include "frame_pacing.hpp"
+#include "frame_scheduler.hpp"
 #include "LuaScriptManager.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <map>
 #include <string>
 #include <atomic>
@@ -17,10 +26,193 @@
 extern std::atomic<bool> appRunning;
 extern PlaybackMode currentPlaybackMode;
 extern OfflinePlaybackState offlineState;
-extern std::map<std::string, Signal> signalRegistry;
+extern SignalRegistry signalRegistry;
 extern LuaScriptManager luaScriptManager;
 extern std::vector<std::string> availableParsers;
 
+// -------------------------------------------------------------------------
+// SIGNAL VIEW ADAPTER FOR IMPLOT GETTERS
+// -------------------------------------------------------------------------
+// Presents a logical slice of a Signal (ring buffer or chunked offline
+// storage) as one contiguous index range for ImPlot's getter-based plotters.
+struct SignalPlotView {
+  const Signal* signal;
+  size_t first; // Logical index plotted as point 0
+};
+
+inline ImPlotPoint SignalPlotViewGetter(int idx, void* data) {
+  const SignalPlotView* view = (const SignalPlotView*)data;
+  size_t i = view->first + (size_t)idx;
+  return ImPlotPoint(view->signal->XAt(i), view->signal->YAt(i));
+}
+
+// Samples [0, count) of a signal as plain arrays: zero-copy when storage is
+// contiguous (always for the mirrored online ring), otherwise gathered into
+// the caller's scratch buffers.
+inline void GetSignalColumns(const Signal& sig, size_t count,
+                             std::vector<double>& scratchX, std::vector<double>& scratchY,
+                             const double*& x, const double*& y) {
+  x = nullptr;
+  y = nullptr;
+  if (count == 0 || sig.Contiguous(0, count, x, y)) return;
+  scratchX.clear();
+  scratchY.clear();
+  scratchX.reserve(count);
+  scratchY.reserve(count);
+  sig.ForEachSpan(0, count, [&](const double* sx, const double* sy, size_t n) {
+    scratchX.insert(scratchX.end(), sx, sx + n);
+    scratchY.insert(scratchY.end(), sy, sy + n);
+  });
+  x = scratchX.data();
+  y = scratchY.data();
+}
+
+// Logical index range of the samples inside [tMin, tMax], padded by one
+// sample on each side so lines still reach the plot edges. Both ends are
+// searches over the time-ordered tail (Signal::LowerBound/UpperBound); if
+// time went backwards somewhere, the unordered prefix is kept whole (any of
+// it may be visible) and only the end of the range is trimmed.
+inline void FindVisibleRange(const Signal& sig, double tMin, double tMax,
+                             size_t& first, size_t& count) {
+  size_t size = sig.Size();
+  size_t sortedFrom = sig.SortedFrom();
+
+  size_t begin = sig.LowerBound(tMin, sortedFrom);
+  size_t end = std::max(begin, sig.UpperBound(tMax, sortedFrom));
+  if (begin > sortedFrom) begin--;
+  if (end < size) end++;
+  if (sortedFrom > 0) begin = 0;
+  first = begin;
+  count = end - begin;
+}
+
+// -------------------------------------------------------------------------
+// FADING TRAIL PLOT ITEM
+// -------------------------------------------------------------------------
+// X/Y trail whose opacity ramps from minAlpha (oldest point) to the color's
+// alpha (newest). One ImPlot item: each segment is a quad with per-vertex
+// colors written straight into the plot draw list, so a long trail costs a
+// single pass instead of one PlotLine call per segment.
+//
+// xs/ys form a ring: point k in time order is (offset + k) % count.
+
+inline void PlotFadingTrail(const char* label_id, const double* xs, const double* ys, int count,
+                            int offset, const ImVec4& color, float weight, float minAlpha) {
+  if (count < 1 || !ImPlot::BeginItem(label_id, ImPlotItemFlags_None, ImPlotCol_Line)) {
+    return;
+  }
+  if (ImPlot::FitThisFrame()) {
+    for (int i = 0; i < count; i++) {
+      ImPlot::FitPoint(ImPlotPoint(xs[i], ys[i]));
+    }
+  }
+
+  ImDrawList* drawList = ImPlot::GetPlotDrawList();
+  const ImVec2 uv = drawList->_Data->TexUvWhitePixel;
+  const float halfWidth = weight * 0.5f;
+  auto colorAt = [&](int k) {
+    float progress = count > 1 ? (float)k / (float)(count - 1) : 1.0f;
+    ImVec4 c = color;
+    c.w *= minAlpha + (1.0f - minAlpha) * progress;
+    return ImGui::ColorConvertFloat4ToU32(c);
+  };
+
+  int first = offset % count;
+  ImVec2 prev = ImPlot::PlotToPixels(xs[first], ys[first]);
+  ImU32 prevCol = colorAt(0);
+
+  // Reserve in batches so one reservation stays within 16-bit vertex indices
+  const int kBatchSegments = 8192;
+  for (int start = 1; start < count; start += kBatchSegments) {
+    int segments = std::min(kBatchSegments, count - start);
+    drawList->PrimReserve(segments * 6, segments * 4);
+    for (int k = start; k < start + segments; k++) {
+      int i = (offset + k) % count;
+      ImVec2 p = ImPlot::PlotToPixels(xs[i], ys[i]);
+      ImU32 col = colorAt(k);
+
+      // Offset both ends along the segment normal
+      float dx = p.x - prev.x;
+      float dy = p.y - prev.y;
+      float len = std::sqrt(dx * dx + dy * dy);
+      float nx = len > 0.0f ? -dy / len * halfWidth : 0.0f;
+      float ny = len > 0.0f ? dx / len * halfWidth : 0.0f;
+
+      ImDrawIdx base = (ImDrawIdx)drawList->_VtxCurrentIdx;
+      drawList->PrimWriteVtx(ImVec2(prev.x + nx, prev.y + ny), uv, prevCol);
+      drawList->PrimWriteVtx(ImVec2(prev.x - nx, prev.y - ny), uv, prevCol);
+      drawList->PrimWriteVtx(ImVec2(p.x - nx, p.y - ny), uv, col);
+      drawList->PrimWriteVtx(ImVec2(p.x + nx, p.y + ny), uv, col);
+      drawList->PrimWriteIdx(base);
+      drawList->PrimWriteIdx((ImDrawIdx)(base + 1));
+      drawList->PrimWriteIdx((ImDrawIdx)(base + 2));
+      drawList->PrimWriteIdx(base);
+      drawList->PrimWriteIdx((ImDrawIdx)(base + 2));
+      drawList->PrimWriteIdx((ImDrawIdx)(base + 3));
+
+      prev = p;
+      prevCol = col;
+    }
+  }
+  ImPlot::EndItem();
+}
+
+// Change how many points an X/Y trail keeps. The ring is unrolled to time
+// order first; shrinking drops the oldest points.
+inline void SetXYTrailLength(XYPlotWindow& xyPlot, int length) {
+  length = std::max(length, 2);
+  auto unroll = [&](std::vector<double>& v) {
+    if (xyPlot.historyOffset > 0 && xyPlot.historyOffset < (int)v.size()) {
+      std::rotate(v.begin(), v.begin() + xyPlot.historyOffset, v.end());
+    }
+    if ((int)v.size() > length) {
+      v.erase(v.begin(), v.end() - length);
+    }
+  };
+  unroll(xyPlot.historyX);
+  unroll(xyPlot.historyY);
+  xyPlot.historyOffset = 0;
+  xyPlot.maxHistorySize = length;
+}
+
+inline void PushXYTrailPoint(XYPlotWindow& xyPlot, double x, double y) {
+  if ((int)xyPlot.historyX.size() < xyPlot.maxHistorySize) {
+    xyPlot.historyX.push_back(x);
+    xyPlot.historyY.push_back(y);
+  } else {
+    xyPlot.historyX[xyPlot.historyOffset] = x;
+    xyPlot.historyY[xyPlot.historyOffset] = y;
+    xyPlot.historyOffset = (xyPlot.historyOffset + 1) % xyPlot.maxHistorySize;
+  }
+}
+
+// Online: add one trail point per sample ingested since the last update, so
+// the trail follows the data rate rather than the (on-demand) frame rate.
+// The new samples of both signals are merged by time; each one pairs with
+// the other signal's latest value at that time (samples sharing a
+// timestamp make one point). Caller holds stateMutex.
+inline void AppendXYTrail(XYPlotWindow& xyPlot, const Signal& xSig, const Signal& ySig) {
+  size_t limit = (size_t)xyPlot.maxHistorySize; // Anything older would scroll out
+  size_t newX = std::min(xyPlot.trailX.Advance(xSig), limit);
+  size_t newY = std::min(xyPlot.trailY.Advance(ySig), limit);
+  if (newX == 0 && newY == 0) return;
+
+  size_t xEnd = xSig.Size(), yEnd = ySig.Size();
+  size_t ix = xEnd - newX, iy = yEnd - newY;
+  bool haveX = ix > 0, haveY = iy > 0;
+  double xVal = haveX ? xSig.YAt(ix - 1) : 0.0;
+  double yVal = haveY ? ySig.YAt(iy - 1) : 0.0;
+  const double kNone = std::numeric_limits<double>::infinity();
+  while (ix < xEnd || iy < yEnd) {
+    double tx = ix < xEnd ? xSig.XAt(ix) : kNone;
+    double ty = iy < yEnd ? ySig.XAt(iy) : kNone;
+    double t = std::min(tx, ty);
+    if (ix < xEnd && tx == t) { xVal = xSig.YAt(ix++); haveX = true; }
+    if (iy < yEnd && ty == t) { yVal = ySig.YAt(iy++); haveY = true; }
+    if (haveX && haveY) PushXYTrailPoint(xyPlot, xVal, yVal);
+  }
+}
+
 // -------------------------------------------------------------------------
 // PARSER SELECTION HELPERS
 // -------------------------------------------------------------------------
@@ -170,29 +362,118 @@ inline void RenderMemoryProfiler(UIPlotState& uiPlotState) {
             size_t totalCurrentPoints = 0;
             size_t totalCapacityPoints = 0;
             
-            ImGui::Columns(4, "SignalColumns");
+            ImGui::Columns(5, "SignalColumns");
             ImGui::Text("Name"); ImGui::NextColumn();
             ImGui::Text("Size"); ImGui::NextColumn();
             ImGui::Text("Cap"); ImGui::NextColumn();
+            ImGui::Text("Ring"); ImGui::NextColumn();
             ImGui::Text("Mem"); ImGui::NextColumn();
             ImGui::Separator();
 
-            for (auto& [name, sig] : signalRegistry) {
-                size_t currentSize = sig.dataX.size();
-                size_t capacity = sig.dataX.capacity(); // Tracking capacity to see peak usage
+            size_t totalBytes = 0;
+            size_t mirroredRings = 0;
+            size_t plainRings = 0;
+            signalRegistry.ForEachSorted([&](const Signal& sig) {
+                size_t currentSize = sig.Size();
+                size_t capacity = sig.CapacitySamples(); // Tracking capacity to see peak usage
+                size_t bytes = sig.MemoryBytes();
                 totalCurrentPoints += currentSize;
                 totalCapacityPoints += capacity;
+                totalBytes += bytes;
 
-                ImGui::Text("%s", name.c_str()); ImGui::NextColumn();
+                ImGui::Text("%s", sig.name.c_str()); ImGui::NextColumn();
                 ImGui::Text("%zu", currentSize); ImGui::NextColumn();
                 ImGui::Text("%zu", capacity); ImGui::NextColumn();
-                ImGui::Text("%.2fMB", (capacity * 2 * sizeof(double)) / (1024.0 * 1024.0)); ImGui::NextColumn();
-            }
+                // Mirrored rings plot zero-copy; plain ones split at the wrap point
+                if (sig.mode == PlaybackMode::ONLINE && sig.ringX.IsAllocated()) {
+                    bool mirrored = sig.ringX.IsMirrored();
+                    (mirrored ? mirroredRings : plainRings)++;
+                    ImGui::Text("%s", mirrored ? "mirrored" : "plain");
+                } else {
+                    ImGui::TextDisabled("-");
+                }
+                ImGui::NextColumn();
+                ImGui::Text("%.2fMB", bytes / (1024.0 * 1024.0)); ImGui::NextColumn();
+            });
             ImGui::Columns(1);
             ImGui::Separator();
-            ImGui::Text("Total Signals: %zu", signalRegistry.size());
+            ImGui::Text("Total Signals: %zu", signalRegistry.Count());
             ImGui::Text("Total Capacity Points: %zu", totalCapacityPoints);
-            ImGui::Text("Total Memory (Est): %.2f MB", (totalCapacityPoints * 2 * sizeof(double)) / (1024.0 * 1024.0));
+            ImGui::Text("Total Memory (Est): %.2f MB", totalBytes / (1024.0 * 1024.0));
+            ImGui::Text("Online Rings: %zu mirrored, %zu plain", mirroredRings, plainRings);
+            ImGui::Text("Pooled Offline Chunks: %zu (%.2f MB idle)", GetSignalChunkPool().IdleChunks(),
+                        (GetSignalChunkPool().IdleChunks() * sizeof(SignalChunk)) / (1024.0 * 1024.0));
+            ImGui::Text("Deferred Frees Pending: %zu", GetSignalEpochs().PendingCount());
+        }
+
+        // Global signal memory budget
+        if (ImGui::CollapsingHeader("Memory Budget", ImGuiTreeNodeFlags_DefaultOpen)) {
+            SignalMemoryBudget& budget = GetSignalMemoryBudget();
+            char overlay[64];
+            snprintf(overlay, sizeof(overlay), "%.1f / %d MB", budget.usedBytes / (1024.0 * 1024.0), budget.budgetMB);
+            ImGui::ProgressBar(std::min(budget.Pressure(), 1.0f), ImVec2(-1, 0), overlay);
+            if (budget.Pressure() > 1.0f) {
+                ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Over budget (%.0f%%)", budget.Pressure() * 100.0f);
+            }
+
+            ImGui::InputInt("Budget (MB)", &budget.budgetMB, 64, 512);
+            budget.budgetMB = std::max(budget.budgetMB, 16);
+            ImGui::Checkbox("Shrink inactive online signals", &budget.shrinkInactive);
+            if (budget.shrinkInactive) {
+                ImGui::InputInt("Inactive history (samples)", &budget.inactiveHistory, 100, 1000);
+                budget.inactiveHistory = std::max(budget.inactiveHistory, 16);
+            }
+            ImGui::Checkbox("Downsample old offline data", &budget.downsampleOld);
+            if (budget.downsampleOld) {
+                ImGui::InputInt("Full-rate recent samples", &budget.keepRecentSamples, 100000, 1000000);
+                budget.keepRecentSamples = std::max(budget.keepRecentSamples, 0);
+            }
+            ImGui::Checkbox("Spill offline data to disk", &budget.spillToDisk);
+
+            ImGui::Checkbox("Compress old offline data", &budget.compressOffline);
+            if (budget.compressOffline) {
+                ImGui::SliderInt("Compress above (% of budget)", &budget.compressAtPercent, 0, 100);
+            }
+            if (budget.compressedChunks > 0) {
+                double raw = budget.compressedChunks * (double)sizeof(SignalChunk);
+                ImGui::Text("Compressed: %zu chunks, %.2f MB (%.1fx)", budget.compressedChunks,
+                            budget.compressedBytes / (1024.0 * 1024.0), raw / std::max<double>(budget.compressedBytes, 1.0));
+                DecodedChunkCache& cache = GetDecodedChunkCache();
+                ImGui::Text("Decode Cache: %.0f MB, %zu hits / %zu misses", cache.MemoryBytes() / (1024.0 * 1024.0),
+                            cache.Hits(), cache.Misses());
+            }
+            ImGui::Text("Spilled to Disk: %.2f MB", budget.spilledBytes / (1024.0 * 1024.0));
+            std::string cacheDir = GetOfflineStorage().Directory();
+            ImGui::Text("Offline Storage: %s", cacheDir.empty() ? "memory" : cacheDir.c_str());
+            ImGui::Text("Mapped Column Files: %.2f MB", budget.mappedBytes / (1024.0 * 1024.0));
+            ImGui::Text("Evictions: %zu shrunk, %zu downsampled, %zu spilled",
+                        budget.shrinkCount, budget.downsampleCount, budget.spillCount);
+        }
+
+        // Per-frame budget for starting analysis window updates
+        if (ImGui::CollapsingHeader("Frame Budget", ImGuiTreeNodeFlags_DefaultOpen)) {
+            FrameScheduler& scheduler = GetFrameScheduler();
+            ImGui::Checkbox("Spread analysis updates across frames", &scheduler.enabled);
+            if (scheduler.enabled) {
+                ImGui::SliderFloat("Analysis budget (ms/frame)", &scheduler.budgetMs, 0.5f, 50.0f, "%.1f ms");
+            }
+            ImGui::Text("Frame: %.2f ms | Started: %d updates (%.2f ms est.)",
+                        scheduler.frameMs, scheduler.started, scheduler.startedMs);
+            ImGui::Text("Deferred: %d (%d granted next frame) | Hidden (skipped): %d",
+                        scheduler.deferred, scheduler.granted, scheduler.hidden);
+        }
+
+        // Frame Pacing
+        if (ImGui::CollapsingHeader("Frame Pacing", ImGuiTreeNodeFlags_DefaultOpen)) {
+            FramePacer& pacer = GetFramePacer();
+            ImGui::Checkbox("Render only when something changes", &pacer.renderOnDemand);
+            ImGui::SliderInt("Max FPS", &pacer.maxFps, 10, 240);
+            if (pacer.renderOnDemand) {
+                ImGui::SliderInt("Idle FPS", &pacer.idleFps, 1, 30);
+            }
+            ImGui::SliderInt("Ingest rate (Hz)", &pacer.ingestHz, 10, 1000);
+            ImGui::Checkbox("VSync", &pacer.vsync);
+            ImGui::Text("Rendering: %.1f FPS | Ingest: %.1f Hz", pacer.renderRate, pacer.ingestRate);
         }
 
         // Lua Memory
@@ -206,20 +487,28 @@ inline void RenderMemoryProfiler(UIPlotState& uiPlotState) {
         if (ImGui::CollapsingHeader("Window Caches", ImGuiTreeNodeFlags_DefaultOpen)) {
              size_t totalCacheBytes = 0;
              for (auto& sw : uiPlotState.activeSpectrograms) {
-                 totalCacheBytes += sw.cachedMagnitudeMatrix.capacity() * sizeof(double);
-                 totalCacheBytes += sw.transposedMagnitudeMatrix.capacity() * sizeof(double);
-                 totalCacheBytes += sw.cachedTimeBins.capacity() * sizeof(double);
+                 totalCacheBytes += sw.columns.Bytes();
+                 totalCacheBytes += sw.rangeScratch.capacity() * sizeof(double);
                  totalCacheBytes += sw.cachedFreqBins.capacity() * sizeof(double);
-                 totalCacheBytes += sw.analyzerData.capacity() * sizeof(double);
-                 totalCacheBytes += sw.analyzerTime.capacity() * sizeof(double);
-                 totalCacheBytes += sw.pffft_buffer_size * 3 * sizeof(float); // work, output, input
+                 totalCacheBytes += sw.analysis.Bytes();
+             }
+             size_t fftCacheBytes = 0;
+             for (auto& f : uiPlotState.activeFFTs) {
+                 fftCacheBytes += f.analysis.Bytes();
+             }
+             size_t histogramCacheBytes = 0;
+             for (auto& h : uiPlotState.activeHistograms) {
+                 histogramCacheBytes += h.analysis.Bytes();
              }
              ImGui::Text("Spectrogram Caches: %.2f MB", totalCacheBytes / (1024.0 * 1024.0));
              ImGui::Text("Active Spectrograms: %zu", uiPlotState.activeSpectrograms.size());
              
              ImGui::Separator();
+             ImGui::Text("FFT Caches: %.2f MB", fftCacheBytes / (1024.0 * 1024.0));
              ImGui::Text("Active FFTs: %zu", uiPlotState.activeFFTs.size());
              ImGui::Text("Active Histograms: %zu", uiPlotState.activeHistograms.size());
+             ImGui::Text("Histogram Caches: %.2f MB", histogramCacheBytes / (1024.0 * 1024.0));
+             ImGui::Text("Analysis Jobs Pending: %zu", GetAnalysisJobs().Pending());
         }
     }
     ImGui::End();
@@ -315,7 +604,8 @@ inline void RenderSignalBrowser(UIPlotState& uiPlotState, float menuBarHeight) {
 
   // Iterate over registry to show draggable items
   ImGui::BeginChild("SignalList");
-  for (auto &[key, signal] : signalRegistry) {
+  signalRegistry.ForEachSorted([](const Signal &signal) {
+    const std::string &key = signal.name;
 
     // Display the item
     ImGui::Selectable(key.c_str());
@@ -330,11 +620,42 @@ inline void RenderSignalBrowser(UIPlotState& uiPlotState, float menuBarHeight) {
       ImGui::Text("Add %s to plot", key.c_str());
       ImGui::EndDragDropSource();
     }
-  }
+  });
   ImGui::EndChild();
   ImGui::End();
 }
 
+// -------------------------------------------------------------------------
+// WINDOW VISIBILITY
+// -------------------------------------------------------------------------
+// Analysis windows only start updates while they can be seen (see
+// frame_scheduler.hpp), and frame pacing only redraws for new data in
+// windows that can be seen (frame_pacing.hpp). ImGui::Begin() already
+// returns false for collapsed windows, hidden dock tabs and windows clipped
+// off-screen; this adds the case of a window entirely covered by another
+// one drawn above it.
+
+inline bool IsCurrentWindowOccluded() {
+  ImGuiContext& g = *GImGui;
+  ImGuiWindow* window = ImGui::GetCurrentWindow();
+  ImGuiWindow* root = window->RootWindowDockTree;
+  ImRect rect = window->Rect();
+  const ImGuiWindowFlags transient = ImGuiWindowFlags_Tooltip | ImGuiWindowFlags_Popup | ImGuiWindowFlags_NoBackground;
+
+  // g.Windows is in display order, back to front
+  bool above = false;
+  for (ImGuiWindow* other : g.Windows) {
+    if (other == root) {
+      above = true;
+      continue;
+    }
+    if (!above || other->RootWindowDockTree != other || (other->Flags & transient)) continue;
+    if (!(other->Active || other->WasActive) || other->Hidden || other->Collapsed) continue;
+    if (other->Rect().Contains(rect)) return true;
+  }
+  return false;
+}
+
 // -------------------------------------------------------------------------
 // TIME-BASED PLOT RENDERING
 // -------------------------------------------------------------------------
@@ -348,7 +669,7 @@ inline void RenderTimePlots(UIPlotState& uiPlotState, float menuBarHeight) {
     // Set window position and size (with screen clamping)
     SetupWindowPositionAndSize(plot, ImVec2(350, menuBarHeight + 20), ImVec2(800, 600));
 
-    ImGui::Begin(plot.title.c_str(), &plot.isOpen);
+    plot.visible = ImGui::Begin(plot.title.c_str(), &plot.isOpen) && !IsCurrentWindowOccluded();
 
     // Plot Header Controls
     if (ImGui::Button(plot.paused ? "Resume" : "Pause")) {
@@ -357,34 +678,39 @@ inline void RenderTimePlots(UIPlotState& uiPlotState, float menuBarHeight) {
     ImGui::SameLine();
     if (ImGui::Button("Clear Signals")) {
       plot.signalNames.clear();
+      plot.lines.clear();
     }
 
     if (ImPlot::BeginPlot("##LinePlot", ImVec2(-1, -1))) {
       ImPlot::SetupAxes("Time (s)", "Value", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
 
       // Axis Logic
+      // When we drive the X limits only the visible slice is decimated;
+      // otherwise X auto-fits and every sample has to be represented.
+      bool xLimitsSet = false;
       if (currentPlaybackMode == PlaybackMode::OFFLINE && offlineState.fileLoaded) {
         // Offline mode: use time window from slider
         double windowEnd = offlineState.currentWindowStart + offlineState.windowWidth;
         ImPlot::SetupAxisLimits(ImAxis_X1, offlineState.currentWindowStart, windowEnd,
                                 ImGuiCond_Always);
+        xLimitsSet = true;
       } else if (!plot.paused && !plot.signalNames.empty()) {
         // Online mode: auto-scroll to show last 5 seconds
         double maxTime = 0;
         for (const auto &sigName : plot.signalNames) {
-          if (signalRegistry.count(sigName)) {
-            Signal &sig = signalRegistry[sigName];
-            if (!sig.dataX.empty()) {
-              int idx =
-                  (sig.offset == 0) ? sig.dataX.size() - 1 : sig.offset - 1;
-              if (sig.dataX[idx] > maxTime)
-                maxTime = sig.dataX[idx];
+          if (Signal *found = signalRegistry.Find(sigName)) {
+            Signal &sig = *found;
+            if (!sig.Empty()) {
+              if (sig.LatestX() > maxTime)
+                maxTime = sig.LatestX();
             }
           }
         }
-        if (maxTime > 0)
+        if (maxTime > 0) {
           ImPlot::SetupAxisLimits(ImAxis_X1, maxTime - 5.0, maxTime,
                                   ImGuiCond_Always);
+          xLimitsSet = true;
+        }
       }
 
       // Drag & Drop Target
@@ -400,17 +726,40 @@ inline void RenderTimePlots(UIPlotState& uiPlotState, float menuBarHeight) {
         ImPlot::EndDragDropTarget();
       }
 
+      // Decimation target: the plot's pixel columns over the current X range
+      ImPlotRect limits = ImPlot::GetPlotLimits();
+      size_t columns = (size_t)std::max(1.0f, ImPlot::GetPlotSize().x);
+
       // Render Lines
       for (const auto &sigName : plot.signalNames) {
-        if (signalRegistry.count(sigName)) {
-          Signal &sig = signalRegistry[sigName];
-          if (!sig.dataX.empty()) {
-            ImPlot::PlotLine(sig.name.c_str(), sig.dataX.data(),
-                             sig.dataY.data(), sig.dataX.size(), 0, sig.offset);
-          } else {
+        if (Signal *found = signalRegistry.Find(sigName)) {
+          Signal &sig = *found;
+          if (sig.Empty()) {
             // Plot empty data to show signal in legend
             double empty[1] = {0};
             ImPlot::PlotLine(sig.name.c_str(), empty, empty, 0);
+            continue;
+          }
+
+          size_t first = 0;
+          size_t count = sig.Size();
+          if (xLimitsSet) {
+            FindVisibleRange(sig, limits.X.Min, limits.X.Max, first, count);
+          }
+
+          // More samples than pixels: draw first/min/max/last per pixel column
+          const double* runX = nullptr;
+          const double* runY = nullptr;
+          DecimatedLine &line = plot.lines[sig.name];
+          if (line.Decimate(sig, first, count, limits.X.Min, limits.X.Max, columns)) {
+            ImPlot::PlotLine(sig.name.c_str(), line.X(), line.Y(), line.Size());
+          } else if (sig.Contiguous(first, count, runX, runY)) {
+            // Mirrored ring (or a single chunk): plot the visible slice straight from storage
+            ImPlot::PlotLine(sig.name.c_str(), runX, runY, (int)count);
+          } else {
+            // Slice spans chunks: go through the getter adapter
+            SignalPlotView view{&sig, first};
+            ImPlot::PlotLineG(sig.name.c_str(), SignalPlotViewGetter, &view, (int)count);
           }
         }
       }
@@ -441,7 +790,7 @@ inline void RenderReadoutBoxes(UIPlotState& uiPlotState, float menuBarHeight) {
     // Use a stable ID (based on readout.id) while displaying dynamic title
     // Format: "DisplayTitle##UniqueID"
     std::string windowID = readout.title + "##Readout" + std::to_string(readout.id);
-    ImGui::Begin(windowID.c_str(), &readout.isOpen);
+    readout.visible = ImGui::Begin(windowID.c_str(), &readout.isOpen) && !IsCurrentWindowOccluded();
 
     // Create a child region to fill the entire window for drag-and-drop
     ImGui::BeginChild("ReadoutContent", ImVec2(0, 0), false, ImGuiWindowFlags_NoScrollbar);
@@ -457,27 +806,21 @@ inline void RenderReadoutBoxes(UIPlotState& uiPlotState, float menuBarHeight) {
       ImGui::TextWrapped("%s", text);
     } else {
       // Display the current value
-      if (signalRegistry.count(readout.signalName)) {
-        Signal &sig = signalRegistry[readout.signalName];
-        if (!sig.dataY.empty()) {
+      if (Signal *found = signalRegistry.Find(readout.signalName)) {
+        Signal &sig = *found;
+        if (!sig.Empty()) {
           // Get the value to display based on mode
           double currentValue;
           if (currentPlaybackMode == PlaybackMode::OFFLINE && offlineState.fileLoaded) {
             // Offline mode: find the value at the current time window end
             double targetTime = offlineState.currentWindowStart + offlineState.windowWidth;
-            // Find the last value before or at targetTime
-            int idx = sig.dataY.size() - 1;
-            for (int i = sig.dataX.size() - 1; i >= 0; i--) {
-              if (sig.dataX[i] <= targetTime) {
-                idx = i;
-                break;
-              }
-            }
-            currentValue = sig.dataY[idx];
+            // Last value before or at targetTime (binary search on time)
+            size_t upper = sig.UpperBound(targetTime);
+            size_t idx = upper > 0 ? upper - 1 : sig.Size() - 1;
+            currentValue = sig.YAt(idx);
           } else {
-            // Online mode: get the most recent value using circular buffer logic
-            int idx = (sig.offset == 0) ? sig.dataY.size() - 1 : sig.offset - 1;
-            currentValue = sig.dataY[idx];
+            // Online mode: get the most recent value
+            currentValue = sig.LatestY();
           }
 
           // Display with larger text, centered
@@ -493,6 +836,24 @@ inline void RenderReadoutBoxes(UIPlotState& uiPlotState, float menuBarHeight) {
           ImGui::Text("%s", valueStr);
           ImGui::SetWindowFontScale(1.0f);
           ImGui::PopFont();
+
+          // Running statistics of the held samples (maintained on ingest)
+          RunningStats st = sig.Stats(true);
+          char statsStr[128];
+          snprintf(statsStr, sizeof(statsStr), "min %.4g  max %.4g  mean %.4g  rms %.4g",
+                   st.min, st.max, st.mean, st.Rms());
+          ImGui::SetCursorPosX(std::max(0.0f, (windowSize.x - ImGui::CalcTextSize(statsStr).x) * 0.5f));
+          ImGui::TextDisabled("%s", statsStr);
+
+          // Sampling rate (smoothed on ingest)
+          SampleRateEstimate rate = sig.Rate();
+          if (rate.Valid()) {
+            char rateStr[96];
+            snprintf(rateStr, sizeof(rateStr), "%.1f Hz  jitter %.2f ms  last gap %.2f ms",
+                     rate.Frequency(), rate.Jitter() * 1000.0, rate.lastGap * 1000.0);
+            ImGui::SetCursorPosX(std::max(0.0f, (windowSize.x - ImGui::CalcTextSize(rateStr).x) * 0.5f));
+            ImGui::TextDisabled("%s", rateStr);
+          }
         } else {
           ImGui::TextDisabled("No data");
         }
@@ -539,7 +900,7 @@ inline void RenderXYPlots(UIPlotState& uiPlotState, float menuBarHeight) {
     // Set window position and size (with screen clamping)
     SetupWindowPositionAndSize(xyPlot, ImVec2(350, menuBarHeight + 20), ImVec2(800, 600));
 
-    ImGui::Begin(xyPlot.title.c_str(), &xyPlot.isOpen);
+    xyPlot.visible = ImGui::Begin(xyPlot.title.c_str(), &xyPlot.isOpen) && !IsCurrentWindowOccluded();
 
     // Plot Header Controls
     if (ImGui::Button(xyPlot.paused ? "Resume" : "Pause")) {
@@ -552,50 +913,51 @@ inline void RenderXYPlots(UIPlotState& uiPlotState, float menuBarHeight) {
       xyPlot.historyX.clear();
       xyPlot.historyY.clear();
       xyPlot.historyOffset = 0;
+      xyPlot.join.Invalidate();
+    }
+    ImGui::SameLine();
+    ImGui::Text("Join:");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(100);
+    const char* joinItems[] = { "Nearest", "Hold", "Linear" };
+    int joinIdx = (int)xyPlot.joinMode;
+    if (ImGui::Combo("##JoinMode", &joinIdx, joinItems, IM_ARRAYSIZE(joinItems))) {
+      xyPlot.joinMode = (JoinMode)joinIdx;
+    }
+    ImGui::SameLine();
+    ImGui::Text("Trail:");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(100);
+    int trailLength = xyPlot.maxHistorySize;
+    if (ImGui::DragInt("##TrailLength", &trailLength, 50.0f, 2, 100000, "%d pts")) {
+      SetXYTrailLength(xyPlot, trailLength);
+    }
+    if (currentPlaybackMode == PlaybackMode::OFFLINE && xyPlot.join.Valid()) {
+      ImGui::SameLine();
+      ImGui::Text("%zu pairs, r = %.3f", xyPlot.join.Span().Size(), xyPlot.join.Correlation());
     }
 
     // Update history based on mode
     if (!xyPlot.paused && !xyPlot.xSignalName.empty() && !xyPlot.ySignalName.empty()) {
-      if (signalRegistry.count(xyPlot.xSignalName) && signalRegistry.count(xyPlot.ySignalName)) {
-        Signal &xSig = signalRegistry[xyPlot.xSignalName];
-        Signal &ySig = signalRegistry[xyPlot.ySignalName];
+      Signal *xFound = signalRegistry.Find(xyPlot.xSignalName);
+      Signal *yFound = signalRegistry.Find(xyPlot.ySignalName);
+      if (xFound && yFound) {
+        Signal &xSig = *xFound;
+        Signal &ySig = *yFound;
 
         if (currentPlaybackMode == PlaybackMode::OFFLINE && offlineState.fileLoaded) {
-          // Offline mode: rebuild history from signals within time window
-          xyPlot.historyX.clear();
-          xyPlot.historyY.clear();
-          xyPlot.historyOffset = 0;
-
+          // Offline mode: Y resampled onto X's timestamps inside the window
+          // (re-joined only when the window or either signal changes)
           double windowStart = offlineState.currentWindowStart;
           double windowEnd = offlineState.currentWindowStart + offlineState.windowWidth;
-
-          // Find overlapping time points (use xSig's time as reference)
-          for (size_t i = 0; i < xSig.dataX.size(); i++) {
-            if (xSig.dataX[i] >= windowStart && xSig.dataX[i] <= windowEnd) {
-              // Find corresponding Y value at the same or closest time
-              // For simplicity, assume signals are sampled together (same index)
-              if (i < ySig.dataY.size()) {
-                xyPlot.historyX.push_back(xSig.dataY[i]);
-                xyPlot.historyY.push_back(ySig.dataY[i]);
-              }
-            }
-          }
-        } else if (!xSig.dataY.empty() && !ySig.dataY.empty()) {
-          // Online mode: get the most recent values and add to circular buffer
-          int xIdx = (xSig.offset == 0) ? xSig.dataY.size() - 1 : xSig.offset - 1;
-          int yIdx = (ySig.offset == 0) ? ySig.dataY.size() - 1 : ySig.offset - 1;
-          double xVal = xSig.dataY[xIdx];
-          double yVal = ySig.dataY[yIdx];
-
-          // Add to history with circular buffer
-          if (xyPlot.historyX.size() < xyPlot.maxHistorySize) {
-            xyPlot.historyX.push_back(xVal);
-            xyPlot.historyY.push_back(yVal);
-          } else {
-            xyPlot.historyX[xyPlot.historyOffset] = xVal;
-            xyPlot.historyY[xyPlot.historyOffset] = yVal;
-            xyPlot.historyOffset = (xyPlot.historyOffset + 1) % xyPlot.maxHistorySize;
+          if (xyPlot.join.Update(xSig, ySig, windowStart, windowEnd, xyPlot.joinMode)) {
+            xyPlot.historyX = xyPlot.join.Span().a;
+            xyPlot.historyY = xyPlot.join.Span().b;
+            xyPlot.historyOffset = 0;
           }
+        } else {
+          // Online mode: one point per new sample, not per rendered frame
+          AppendXYTrail(xyPlot, xSig, ySig);
         }
       }
     }
@@ -637,34 +999,17 @@ inline void RenderXYPlots(UIPlotState& uiPlotState, float menuBarHeight) {
             xyPlot.historyX.clear();
             xyPlot.historyY.clear();
             xyPlot.historyOffset = 0;
+            xyPlot.join.Invalidate();
           }
         }
         ImPlot::EndDragDropTarget();
       }
 
-      // Render X/Y plot with fading effect
+      // Render X/Y plot with fading effect (newest points most opaque)
       if (!xyPlot.historyX.empty() && xyPlot.historyX.size() == xyPlot.historyY.size()) {
-        // Draw segments with fading alpha
-        int numPoints = xyPlot.historyX.size();
-
-        for (int i = 1; i < numPoints; i++) {
-          int idx1 = (xyPlot.historyOffset + i - 1) % numPoints;
-          int idx2 = (xyPlot.historyOffset + i) % numPoints;
-
-          // Calculate fade: newer points (closer to offset) are more opaque
-          float progress = (float)i / (float)numPoints;
-          float alpha = 0.2f + 0.8f * progress; // Range from 0.2 to 1.0
-
-          ImVec4 color = ImPlot::GetColormapColor(0);
-          color.w = alpha;
-
-          ImPlot::SetNextLineStyle(color, 2.0f);
-
-          double x[2] = {xyPlot.historyX[idx1], xyPlot.historyX[idx2]};
-          double y[2] = {xyPlot.historyY[idx1], xyPlot.historyY[idx2]};
-
-          ImPlot::PlotLine("##segment", x, y, 2);
-        }
+        PlotFadingTrail("##trail", xyPlot.historyX.data(), xyPlot.historyY.data(),
+                        (int)xyPlot.historyX.size(), xyPlot.historyOffset,
+                        ImPlot::GetColormapColor(0), 2.0f, 0.2f);
       }
 
       ImPlot::EndPlot();
@@ -691,7 +1036,7 @@ inline void RenderHistograms(UIPlotState& uiPlotState, float menuBarHeight) {
 
     // Use a stable ID (based on histogram.id) while displaying dynamic title
     std::string windowID = histogram.title + "##Histogram" + std::to_string(histogram.id);
-    ImGui::Begin(windowID.c_str(), &histogram.isOpen);
+    histogram.visible = ImGui::Begin(windowID.c_str(), &histogram.isOpen) && !IsCurrentWindowOccluded();
 
     // Display content based on whether a signal is assigned
     if (histogram.signalName.empty()) {
@@ -714,8 +1059,8 @@ inline void RenderHistograms(UIPlotState& uiPlotState, float menuBarHeight) {
       }
     } else {
       // Display the histogram
-      if (signalRegistry.count(histogram.signalName)) {
-        Signal &sig = signalRegistry[histogram.signalName];
+      if (Signal *found = signalRegistry.Find(histogram.signalName)) {
+        Signal &sig = *found;
 
         // Controls at the top
         ImGui::Text("Bins:");
@@ -728,42 +1073,46 @@ inline void RenderHistograms(UIPlotState& uiPlotState, float menuBarHeight) {
           histogram.title = "Histogram " + std::to_string(histogram.id);
         }
 
-        if (!sig.dataY.empty()) {
-          // Collect data points based on mode
-          std::vector<double> dataToHistogram;
-
+        if (!sig.Empty()) {
+          size_t count = sig.Size();
           if (currentPlaybackMode == PlaybackMode::OFFLINE && offlineState.fileLoaded) {
             // Offline mode: collect all data up to current time window end
             double targetTime = offlineState.currentWindowStart + offlineState.windowWidth;
-            for (size_t i = 0; i < sig.dataX.size(); i++) {
-              if (sig.dataX[i] <= targetTime) {
-                dataToHistogram.push_back(sig.dataY[i]);
-              } else {
-                break; // Assuming data is chronologically ordered
-              }
-            }
-          } else {
-            // Online mode: use all data in the circular buffer
-            if (sig.mode == PlaybackMode::ONLINE && sig.dataY.size() == sig.maxSize) {
-              // Buffer is full, use circular logic
-              for (size_t i = 0; i < sig.dataY.size(); i++) {
-                int idx = (sig.offset + i) % sig.dataY.size();
-                dataToHistogram.push_back(sig.dataY[idx]);
+            count = sig.UpperBound(targetTime);
+          }
+
+          if (count > 0) {
+            // Only samples added or evicted since the last update are
+            // (un)counted, on an analysis thread; draw the latest bars
+            FrameScheduler& scheduler = GetFrameScheduler();
+            uint64_t scheduleKey = ScheduleKey(ScheduledKind::Histogram, histogram.id);
+            histogram.analysis.Collect();
+            const HistogramUpdate& counted = histogram.analysis.Latest().update;
+            uint64_t base = sig.totalCount - sig.Size();
+            bool needsUpdate = counted.source != &sig || counted.generation != sig.generation ||
+                               counted.numBins != histogram.numBins || counted.base != base ||
+                               counted.targetEnd != base + count;
+            if (needsUpdate && !histogram.analysis.Busy()) {
+              if (!histogram.visible) {
+                scheduler.Hidden(scheduleKey);
+              } else if (scheduler.Request(scheduleKey, ImGui::IsWindowFocused())) {
+                auto prepStart = std::chrono::steady_clock::now();
+                HistogramJob& job = histogram.analysis.Next();
+                if (histogram.analysis.Scratch().Plan(sig, count, histogram.numBins, job.update)) {
+                  histogram.analysis.Submit(RunHistogramJob);
+                  scheduler.RecordPrep(scheduleKey, MillisecondsSince(prepStart));
+                }
               }
-            } else {
-              // Buffer not full yet, use all data
-              dataToHistogram = sig.dataY;
             }
-          }
 
-          if (!dataToHistogram.empty()) {
             // Plot the histogram
-            if (ImPlot::BeginPlot("##Histogram", ImVec2(-1, -1))) {
+            const HistogramJob& shown = histogram.analysis.Latest();
+            if (shown.counts.empty()) {
+              ImGui::TextDisabled("Computing...");
+            } else if (ImPlot::BeginPlot("##Histogram", ImVec2(-1, -1))) {
               ImPlot::SetupAxes("Value", "Count", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
-
-              ImPlot::PlotHistogram("##HistData", dataToHistogram.data(),
-                                   (int)dataToHistogram.size(), histogram.numBins);
-
+              ImPlot::PlotBars("##HistData", shown.centers.data(), shown.counts.data(),
+                               (int)shown.counts.size(), shown.binWidth);
               ImPlot::EndPlot();
             }
           } else {
@@ -808,7 +1157,7 @@ inline void RenderFFTPlots(UIPlotState& uiPlotState, float menuBarHeight) {
 
     // Use a stable ID (based on fft.id) while displaying dynamic title
     std::string windowID = fft.title + "##FFT" + std::to_string(fft.id);
-    ImGui::Begin(windowID.c_str(), &fft.isOpen);
+    fft.visible = ImGui::Begin(windowID.c_str(), &fft.isOpen) && !IsCurrentWindowOccluded();
 
     // Display content based on whether a signal is assigned
     if (fft.signalName.empty()) {
@@ -831,8 +1180,8 @@ inline void RenderFFTPlots(UIPlotState& uiPlotState, float menuBarHeight) {
       }
     } else {
       // Display the FFT
-      if (signalRegistry.count(fft.signalName)) {
-        Signal &sig = signalRegistry[fft.signalName];
+      if (Signal *found = signalRegistry.Find(fft.signalName)) {
+        Signal &sig = *found;
 
         // Controls at the top
         ImGui::Text("FFT Size:");
@@ -853,78 +1202,148 @@ inline void RenderFFTPlots(UIPlotState& uiPlotState, float menuBarHeight) {
         }
 
         ImGui::SameLine();
-        ImGui::Checkbox("Hanning Window", &fft.useHanning);
+        ImGui::Text("Window:");
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(140);
+        int fftWindowIdx = (int)fft.window;
+        if (ImGui::Combo("##FFTWindow", &fftWindowIdx, kWindowTypeLabels, IM_ARRAYSIZE(kWindowTypeLabels))) {
+          fft.window = (WindowType)fftWindowIdx;
+        }
 
         ImGui::SameLine();
         ImGui::Checkbox("Log Scale (dB)", &fft.logScale);
 
+        ImGui::SameLine();
+        ImGui::Checkbox("Welch PSD", &fft.welch);
+        if (fft.welch) {
+          ImGui::SameLine();
+          ImGui::SetNextItemWidth(100);
+          float overlapPercent = fft.welchOverlap * 100.0f;
+          if (ImGui::DragFloat("##WelchOverlap", &overlapPercent, 1.0f, 0.0f, 90.0f, "Overlap %.0f%%")) {
+            fft.welchOverlap = overlapPercent / 100.0f;
+          }
+          ImGui::SameLine();
+          ImGui::Checkbox("Parallel", &fft.parallel);
+        }
+
         ImGui::SameLine();
         if (ImGui::Button("Clear Signal")) {
           fft.signalName = "";
           fft.title = "FFT " + std::to_string(fft.id);
         }
 
-        if (!sig.dataY.empty()) {
-          // Collect data points based on mode
-          std::vector<double> dataToFFT;
-          std::vector<double> timeToFFT;
-
+        if (!sig.Empty()) {
+          size_t count = sig.Size();
+          size_t first = 0; // Welch: first sample averaged over
           if (currentPlaybackMode == PlaybackMode::OFFLINE && offlineState.fileLoaded) {
             // Offline mode: collect all data up to current time window end
             double targetTime = offlineState.currentWindowStart + offlineState.windowWidth;
-            for (size_t i = 0; i < sig.dataX.size(); i++) {
-              if (sig.dataX[i] <= targetTime) {
-                timeToFFT.push_back(sig.dataX[i]);
-                dataToFFT.push_back(sig.dataY[i]);
-              } else {
-                break; // Assuming data is chronologically ordered
-              }
-            }
+            count = sig.UpperBound(targetTime);
+            if (sig.IsMonotonic()) first = std::min(sig.LowerBound(offlineState.currentWindowStart), count);
+          }
+          if (!fft.welch || count - first < (size_t)fft.fftSize) {
+            first = count >= (size_t)fft.fftSize ? count - fft.fftSize : 0;
           } else {
-            // Online mode: use all data in the circular buffer
-            if (sig.mode == PlaybackMode::ONLINE && sig.dataY.size() == sig.maxSize) {
-              // Buffer is full, use circular logic
-              for (size_t i = 0; i < sig.dataY.size(); i++) {
-                int idx = (sig.offset + i) % sig.dataY.size();
-                timeToFFT.push_back(sig.dataX[idx]);
-                dataToFFT.push_back(sig.dataY[idx]);
-              }
-            } else {
-              // Buffer not full yet, use all data
-              timeToFFT = sig.dataX;
-              dataToFFT = sig.dataY;
-            }
+            first = std::max(first, count - std::min(count, WelchMaxSamples(fft.fftSize, fft.welchOverlap)));
           }
 
-          if (dataToFFT.size() >= (size_t)fft.fftSize) {
-            // Compute FFT spectrum
-            std::vector<double> freqBins;
-            std::vector<double> magnitude;
+          // Sampling rate is tracked incrementally as samples arrive
+          SampleRateEstimate rate = sig.Rate();
+          double fs = rate.Frequency(1.0);
+
+          if (count >= (size_t)fft.fftSize) {
+            // Resubmit on a settings/signal change or a scrubbed offline
+            // window right away; while streaming, only once enough new
+            // samples arrived and the throttle interval has passed. The
+            // spectrum is computed on an analysis thread and the plot shows
+            // the latest finished one meanwhile.
+            FrameScheduler& scheduler = GetFrameScheduler();
+            uint64_t scheduleKey = ScheduleKey(ScheduledKind::FFT, fft.id);
+            fft.analysis.Collect();
+            const FFTJob& shown = fft.analysis.Latest();
+            uint64_t base = sig.totalCount - sig.Size();
+            uint64_t begin = base + first;
+            uint64_t end = base + count;
+            bool settingsChanged = shown.signal != &sig ||
+                                   shown.generation != sig.generation ||
+                                   shown.fftSize != fft.fftSize ||
+                                   shown.window != fft.window ||
+                                   shown.logScale != fft.logScale ||
+                                   shown.welch != fft.welch ||
+                                   (fft.welch && shown.overlap != fft.welchOverlap) ||
+                                   shown.freqBins.empty();
+            bool needsUpdate = settingsChanged;
+            if (!needsUpdate && (end != shown.end || begin != shown.begin)) {
+              double now = ImGui::GetTime();
+              uint64_t minNew = (uint64_t)std::max(1, fft.fftSize / FFTWindow::kNewSampleDivisor);
+              bool streaming = sig.mode == PlaybackMode::ONLINE && end >= shown.end;
+              needsUpdate = !streaming || (end - shown.end >= minNew &&
+                                           now - fft.lastComputeTime >= fft.updateThrottleSeconds);
+            }
 
-            ComputeFFTSpectrum(dataToFFT, timeToFFT, fft.fftSize, fft.useHanning, fft.logScale, freqBins, magnitude);
+            if (needsUpdate && !fft.analysis.Busy() && !fft.visible) {
+              scheduler.Hidden(scheduleKey);
+            } else if (needsUpdate && !fft.analysis.Busy() &&
+                       scheduler.Request(scheduleKey, ImGui::IsWindowFocused())) {
+              // Snapshot the settings and copy the samples analyzed: the
+              // job never reads the signal
+              auto prepStart = std::chrono::steady_clock::now();
+              FFTJob& job = fft.analysis.Next();
+              job.signal = &sig;
+              job.generation = sig.generation;
+              job.begin = begin;
+              job.end = end;
+              job.fftSize = fft.fftSize;
+              job.window = fft.window;
+              job.logScale = fft.logScale;
+              job.welch = fft.welch;
+              job.overlap = fft.welchOverlap;
+              job.parallel = fft.parallel;
+              job.fs = fs;
+              job.values.clear();
+              job.values.reserve(count - first);
+              sig.ForEachSpan(first, count - first, [&](const double*, const double* y, size_t n) {
+                job.values.insert(job.values.end(), y, y + n);
+              });
+              fft.analysis.Submit(RunFFTJob);
+              fft.lastComputeTime = ImGui::GetTime();
+              scheduler.RecordPrep(scheduleKey, MillisecondsSince(prepStart));
+            }
+            fs = shown.fs;
+            const std::vector<double>& freqBins = shown.freqBins;
+            const std::vector<double>& magnitude = shown.magnitude;
 
             if (!freqBins.empty() && !magnitude.empty()) {
-              // Calculate sampling frequency for display
-              double fs = CalculateSamplingFrequency(timeToFFT, std::max(0, (int)timeToFFT.size() - fft.fftSize),
-                                                     std::min(fft.fftSize, (int)timeToFFT.size()));
-
-              ImGui::Text("Sampling Frequency: %.2f Hz | Frequency Resolution: %.3f Hz",
-                         fs, fs / fft.fftSize);
+              if (shown.welch) {
+                ImGui::Text("Sampling Frequency: %.2f Hz | Frequency Resolution: %.3f Hz | Welch: %d segments",
+                           fs, fs / shown.fftSize, shown.welchSegments);
+              } else {
+                ImGui::Text("Sampling Frequency: %.2f Hz | Frequency Resolution: %.3f Hz",
+                           fs, fs / shown.fftSize);
+              }
+              if (rate.Valid() && !rate.IsRegular()) {
+                ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f),
+                                   "Irregular sampling: jitter %.0f%% of dt, largest gap %.3f s",
+                                   100.0 * rate.Jitter() / rate.dt, rate.maxGap);
+              }
 
               // Plot the FFT spectrum
               if (ImPlot::BeginPlot("##FFTPlot", ImVec2(-1, -1))) {
-                const char* yAxisLabel = fft.logScale ? "Magnitude (dB)" : "Magnitude";
+                const char* yAxisLabel = shown.welch ? (shown.logScale ? "PSD (dB V^2/Hz)" : "PSD (V^2/Hz)")
+                                                     : (shown.logScale ? "Magnitude (dB)" : "Magnitude");
                 ImPlot::SetupAxes("Frequency (Hz)", yAxisLabel, ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
 
                 ImPlot::PlotLine("##FFTLine", freqBins.data(), magnitude.data(), (int)freqBins.size());
 
                 ImPlot::EndPlot();
               }
+            } else if (fft.analysis.Busy()) {
+              ImGui::TextDisabled("Computing...");
             } else {
               ImGui::TextDisabled("FFT computation failed");
             }
           } else {
-            ImGui::TextDisabled("Not enough data for FFT (need %d samples, have %zu)", fft.fftSize, dataToFFT.size());
+            ImGui::TextDisabled("Not enough data for FFT (need %d samples, have %zu)", fft.fftSize, count);
           }
         } else {
           ImGui::TextDisabled("No data");
@@ -972,7 +1391,7 @@ inline void RenderSpectrograms(UIPlotState& uiPlotState, float menuBarHeight) {
     SetupWindowPositionAndSize(spectrogram, ImVec2(350, menuBarHeight + 20), ImVec2(900, 600));
 
     std::string windowID = spectrogram.title + "##Spectrogram" + std::to_string(spectrogram.id);
-    ImGui::Begin(windowID.c_str(), &spectrogram.isOpen);
+    spectrogram.visible = ImGui::Begin(windowID.c_str(), &spectrogram.isOpen) && !IsCurrentWindowOccluded();
 
     if (spectrogram.signalName.empty()) {
       ImVec2 windowSize = ImGui::GetWindowSize();
@@ -991,8 +1410,8 @@ inline void RenderSpectrograms(UIPlotState& uiPlotState, float menuBarHeight) {
         ImGui::EndDragDropTarget();
       }
     } else {
-      if (signalRegistry.count(spectrogram.signalName)) {
-        Signal &sig = signalRegistry[spectrogram.signalName];
+      if (Signal *found = signalRegistry.Find(spectrogram.signalName)) {
+        Signal &sig = *found;
 
         // Controls
         ImGui::Text("FFT Size:");
@@ -1022,7 +1441,11 @@ inline void RenderSpectrograms(UIPlotState& uiPlotState, float menuBarHeight) {
         }
 
         ImGui::SameLine();
-        ImGui::Checkbox("Hanning", &spectrogram.useHanning);
+        ImGui::SetNextItemWidth(140);
+        int spectWindowIdx = (int)spectrogram.window;
+        if (ImGui::Combo("##SpectWindow", &spectWindowIdx, kWindowTypeLabels, IM_ARRAYSIZE(kWindowTypeLabels))) {
+          spectrogram.window = (WindowType)spectWindowIdx;
+        }
 
         ImGui::SameLine();
         ImGui::Checkbox("Log (dB)", &spectrogram.logScale);
@@ -1050,124 +1473,123 @@ inline void RenderSpectrograms(UIPlotState& uiPlotState, float menuBarHeight) {
         }
         ImGui::SameLine();
         ImGui::Checkbox("Interpolation", &spectrogram.useInterpolation);
+        ImGui::SameLine();
+        ImGui::Checkbox("Parallel", &spectrogram.parallel);
 
-        if (!sig.dataY.empty()) {
-            // Determine if we need to recompute the spectrogram
-            bool needsUpdate = false;
-            if (currentPlaybackMode == PlaybackMode::OFFLINE) {
-                if (offlineState.currentWindowStart != spectrogram.cachedWindowStart || 
-                    offlineState.windowWidth != spectrogram.cachedWindowWidth ||
-                    sig.dataX.size() != spectrogram.cachedDataSize) {
-                    needsUpdate = true;
-                }
-            } else {
-                if (sig.dataX.size() != spectrogram.cachedDataSize || 
-                    sig.offset != spectrogram.cachedOffset) {
-                    needsUpdate = true;
-                }
-            }
-            
-            // Recompute if parameters changed
-            if (spectrogram.fftSize != spectrogram.cachedFftSize ||
-                spectrogram.hopSize != spectrogram.cachedHopSize ||
-                spectrogram.logScale != spectrogram.cachedLogScale ||
-                spectrogram.useHanning != spectrogram.cachedUseHanning ||
-                spectrogram.maxFrequency != spectrogram.cachedMaxFrequency) {
-                needsUpdate = true;
-            }
-
-            if (needsUpdate) {
-              // Collect data points for analysis into cached buffers to avoid reallocations
-              spectrogram.analyzerData.clear();
-              spectrogram.analyzerTime.clear();
+        // Third row: color scale limits
+        bool rangeChanged = false;
+        ImGui::Text("Range:");
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(120);
+        const char* rangeItems[] = { "Auto", "Percentile", "Fixed" };
+        int rangeIdx = (int)spectrogram.rangeMode;
+        if (ImGui::Combo("##SpectRange", &rangeIdx, rangeItems, IM_ARRAYSIZE(rangeItems))) {
+          spectrogram.rangeMode = (SpectrogramRange)rangeIdx;
+          rangeChanged = true;
+        }
+        if (spectrogram.rangeMode == SpectrogramRange::Fixed) {
+          ImGui::SameLine();
+          ImGui::SetNextItemWidth(200);
+          rangeChanged |= ImGui::DragFloatRange2("##SpectFixedRange", &spectrogram.fixedMin, &spectrogram.fixedMax,
+                                                 0.5f, -300.0f, 300.0f, "Min %.1f", "Max %.1f");
+        } else if (spectrogram.rangeMode == SpectrogramRange::Percentile) {
+          ImGui::SameLine();
+          ImGui::SetNextItemWidth(200);
+          rangeChanged |= ImGui::DragFloatRange2("##SpectPercentiles", &spectrogram.percentileLow, &spectrogram.percentileHigh,
+                                                 0.1f, 0.0f, 100.0f, "Low %.1f%%", "High %.1f%%");
+        }
 
+        if (!sig.Empty()) {
+            // New hops are transformed as they arrive; while streaming, batch
+            // them up to updateThrottleSeconds (settings changes apply at once)
+            double now = ImGui::GetTime();
+            bool settingsChanged = spectrogram.cachedSignal != &sig ||
+                                   spectrogram.cachedGeneration != sig.generation ||
+                                   spectrogram.fftSize != spectrogram.cachedFftSize ||
+                                   spectrogram.hopSize != spectrogram.cachedHopSize ||
+                                   spectrogram.logScale != spectrogram.cachedLogScale ||
+                                   spectrogram.window != spectrogram.cachedWindow ||
+                                   spectrogram.maxFrequency != spectrogram.cachedMaxFrequency;
+            bool throttled = sig.mode == PlaybackMode::ONLINE && !settingsChanged &&
+                             now - spectrogram.lastComputeTime < spectrogram.updateThrottleSeconds;
+
+            // Finished jobs are applied to the column ring here; new hops are
+            // transformed on an analysis thread while the old columns show
+            // (applying counts toward the window's frame-budget cost)
+            FrameScheduler& scheduler = GetFrameScheduler();
+            uint64_t scheduleKey = ScheduleKey(ScheduledKind::Spectrogram, spectrogram.id);
+            if (spectrogram.analysis.Collect()) {
+              auto applyStart = std::chrono::steady_clock::now();
+              rangeChanged |= ApplySpectrogramJob(spectrogram.analysis.Latest(), spectrogram);
+              scheduler.RecordApply(scheduleKey, MillisecondsSince(applyStart));
+            }
+            if (!throttled && !spectrogram.analysis.Busy()) {
+              size_t count = sig.Size();
               if (currentPlaybackMode == PlaybackMode::OFFLINE && offlineState.fileLoaded) {
                 double targetTime = offlineState.currentWindowStart + offlineState.windowWidth;
-                for (size_t i = 0; i < sig.dataX.size(); i++) {
-                  if (sig.dataX[i] <= targetTime) {
-                    spectrogram.analyzerTime.push_back(sig.dataX[i]);
-                    spectrogram.analyzerData.push_back(sig.dataY[i]);
-                  } else break;
-                }
-              } else {
-                if (sig.mode == PlaybackMode::ONLINE && sig.dataY.size() == sig.maxSize) {
-                  spectrogram.analyzerTime.reserve(sig.maxSize);
-                  spectrogram.analyzerData.reserve(sig.maxSize);
-                  for (size_t i = 0; i < sig.dataY.size(); i++) {
-                    int idx = (sig.offset + i) % sig.dataY.size();
-                    spectrogram.analyzerTime.push_back(sig.dataX[idx]);
-                    spectrogram.analyzerData.push_back(sig.dataY[idx]);
-                  }
-                } else {
-                  spectrogram.analyzerTime = sig.dataX;
-                  spectrogram.analyzerData = sig.dataY;
-                }
+                count = sig.UpperBound(targetTime);
               }
 
-              if (spectrogram.analyzerData.size() >= (size_t)spectrogram.fftSize) {
-                ComputeSpectrogram(spectrogram.analyzerData, spectrogram.analyzerTime, spectrogram);
-                
-                // Calculate sampling frequency and cache it
-                spectrogram.cachedFs = CalculateSamplingFrequency(spectrogram.analyzerTime, std::max(0, (int)spectrogram.analyzerTime.size() - spectrogram.fftSize),
-                                                                 std::min(spectrogram.fftSize, (int)spectrogram.analyzerTime.size()));
-
-                // Update cache metadata
-                spectrogram.cachedDataSize = sig.dataX.size();
-                spectrogram.cachedOffset = sig.offset;
-                spectrogram.cachedWindowStart = offlineState.currentWindowStart;
-                spectrogram.cachedWindowWidth = offlineState.windowWidth;
-                spectrogram.cachedFftSize = spectrogram.fftSize;
-                spectrogram.cachedHopSize = spectrogram.hopSize;
-                spectrogram.cachedLogScale = spectrogram.logScale;
-                spectrogram.cachedUseHanning = spectrogram.useHanning;
-                spectrogram.cachedMaxFrequency = spectrogram.maxFrequency;
-
-                // Handle transposition
-                int numTimeBins = spectrogram.cachedTimeBins.size();
-                int numFreqBins = spectrogram.cachedFreqBins.size();
-                if (numTimeBins > 0 && numFreqBins > 0) {
-                  spectrogram.transposedMagnitudeMatrix.resize(numTimeBins * numFreqBins);
-                  for (int t = 0; t < numTimeBins; t++) {
-                    for (int f = 0; f < numFreqBins; f++) {
-                      int srcIdx = t * numFreqBins + f;
-                      int dstIdx = (numFreqBins - 1 - f) * numTimeBins + t;
-                      spectrogram.transposedMagnitudeMatrix[dstIdx] = spectrogram.cachedMagnitudeMatrix[srcIdx];
-                    }
-                  }
-                }
+              // Planning is a few binary searches, so it runs every frame;
+              // only a plan with columns to transform asks the frame
+              // scheduler for a turn (trims and no-ops cost nothing)
+              double fs = sig.Rate().Frequency(1.0); // Tracked incrementally as samples arrive
+              SpectrogramJob& job = spectrogram.analysis.Next();
+              if (!PlanSpectrogram(sig, count, fs, spectrogram, job)) {
+                spectrogram.lastComputeTime = now;
+              } else if (job.pending.empty()) {
+                rangeChanged |= ApplySpectrogramJob(job, spectrogram); // Only trimming
+                spectrogram.lastComputeTime = now;
+              } else if (!spectrogram.visible) {
+                scheduler.Hidden(scheduleKey);
+              } else if (scheduler.Request(scheduleKey, ImGui::IsWindowFocused())) {
+                auto prepStart = std::chrono::steady_clock::now();
+                GatherSpectrogramInputs(sig, job);
+                spectrogram.analysis.Submit(RunSpectrogramJob);
+                spectrogram.lastComputeTime = now;
+                scheduler.RecordPrep(scheduleKey, MillisecondsSince(prepStart));
               }
             }
+            if (rangeChanged || spectrogram.rangeMode == SpectrogramRange::Fixed) {
+              UpdateSpectrogramRange(spectrogram);
+            }
 
-            if (!spectrogram.cachedTimeBins.empty() && !spectrogram.cachedFreqBins.empty() && !spectrogram.cachedMagnitudeMatrix.empty()) {
+            if (!spectrogram.columns.Empty() && !spectrogram.cachedFreqBins.empty()) {
               ImGui::Text("Sampling Freq: %.2f Hz | Time Bins: %zu | Freq Bins: %zu | Freq Res: %.3f Hz",
-                         spectrogram.cachedFs, spectrogram.cachedTimeBins.size(), spectrogram.cachedFreqBins.size(), spectrogram.cachedFs / spectrogram.fftSize);
+                         spectrogram.cachedFs, spectrogram.columns.Count(), spectrogram.cachedFreqBins.size(), spectrogram.cachedFs / spectrogram.fftSize);
 
               // Plot the spectrogram
               if (ImPlot::BeginPlot("##SpectrogramPlot", ImVec2(-1, -1))) {
                 ImPlot::SetupAxes("Time (s)", "Frequency (Hz)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
 
-                // Determine bounds
-                int numTimeBins = spectrogram.cachedTimeBins.size();
-                int numFreqBins = spectrogram.cachedFreqBins.size();
-                double timeMin = spectrogram.cachedTimeBins.front();
-                double timeMax = spectrogram.cachedTimeBins.back();
+                // Determine bounds: columns are evenly spaced by one hop, each
+                // cell centered on its column time
+                const SpectrogramColumns& columns = spectrogram.columns;
+                int numFreqBins = columns.Bins();
+                double timeMin = columns.FrontTime();
+                double columnWidth = columns.Count() > 1
+                                         ? (columns.BackTime() - timeMin) / (double)(columns.Count() - 1)
+                                         : spectrogram.cachedHopSize / std::max(spectrogram.cachedFs, 1e-9);
                 double freqMin = spectrogram.cachedFreqBins.front();
                 double freqMax = spectrogram.cachedFreqBins.back();
 
-                // Find min/max magnitude for normalization if using PlotHeatmap scale
-                double magMin = *std::min_element(spectrogram.cachedMagnitudeMatrix.begin(), spectrogram.cachedMagnitudeMatrix.end());
-                double magMax = *std::max_element(spectrogram.cachedMagnitudeMatrix.begin(), spectrogram.cachedMagnitudeMatrix.end());
-
+                // The column ring is already a column-major heatmap: one call per
+                // contiguous run (two when it wraps), no transpose
                 if (spectrogram.colormap != Colormap::ImPlotDefault) ImPlot::PushColormap(MapToImPlotColormap(spectrogram.colormap));
-                ImPlot::PlotHeatmap("##HeatmapData", spectrogram.transposedMagnitudeMatrix.data(),
-                                   numFreqBins, numTimeBins,
-                                   magMin, magMax,
-                                   nullptr,
-                                   ImPlotPoint(timeMin, freqMin),
-                                   ImPlotPoint(timeMax, freqMax));
+                columns.ForEachRun([&](const double* mags, size_t first, size_t n) {
+                  ImPlot::PlotHeatmap(first == 0 ? "##HeatmapData" : "##HeatmapDataWrap", mags,
+                                     numFreqBins, (int)n,
+                                     spectrogram.magMin, spectrogram.magMax,
+                                     nullptr,
+                                     ImPlotPoint(timeMin + (first - 0.5) * columnWidth, freqMin),
+                                     ImPlotPoint(timeMin + (first + n - 0.5) * columnWidth, freqMax),
+                                     ImPlotHeatmapFlags_ColMajor);
+                });
                 if (spectrogram.colormap != Colormap::ImPlotDefault) ImPlot::PopColormap();
                 ImPlot::EndPlot();
               }
+            } else if (spectrogram.analysis.Busy()) {
+              ImGui::TextDisabled("Computing...");
             } else {
               ImGui::TextDisabled("Spectrogram computation failed");
             }
@@ -1,8 +1,17 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
-#include "pffft.h"
+#include "analysis_jobs.hpp"
+#include "fft_workspace.hpp"
+#include "signal_decimation.hpp"
+#include "signal_histogram.hpp"
+#include "signal_join.hpp"
+#include "spectrogram_columns.hpp"
+#include "window_functions.hpp"
 
 // -------------------------------------------------------------------------
 // PLOT WINDOW DATA STRUCTURES
@@ -17,7 +26,10 @@ struct PlotWindow {
   std::vector<std::string> signalNames; // List of keys to look up in Registry
   bool paused = false;
   bool isOpen = true;
+  bool visible = true; // On screen last frame (see IsCurrentWindowOccluded)
 
+  // M4-decimated lines by signal name (kept across frames, see signal_decimation.hpp)
+  std::unordered_map<std::string, DecimatedLine> lines;
 };
 
 // Represents one Readout Box (single numeric value display)
@@ -26,9 +38,31 @@ struct ReadoutBox {
   std::string title;
   std::string signalName; // Single signal to display (empty if none assigned)
   bool isOpen = true;
+  bool visible = true; // On screen last frame (see IsCurrentWindowOccluded)
 
 };
 
+// Online X/Y trail: how far into one signal's samples the trail has read
+struct XYTrailCursor {
+  const Signal* signal = nullptr;
+  uint32_t generation = 0;
+  uint64_t count = 0; // sig.totalCount when last read
+
+  // Samples added to sig since the last call (the newest one after a reset
+  // or a different signal)
+  size_t Advance(const Signal& sig) {
+    if (signal != &sig || generation != sig.generation || sig.totalCount < count) {
+      signal = &sig;
+      generation = sig.generation;
+      count = sig.totalCount;
+      return sig.Empty() ? 0 : 1;
+    }
+    size_t added = (size_t)std::min<uint64_t>(sig.totalCount - count, sig.Size());
+    count = sig.totalCount;
+    return added;
+  }
+};
+
 // Represents one X/Y Plot (scatter plot with history)
 struct XYPlotWindow {
   int id;
@@ -37,12 +71,19 @@ struct XYPlotWindow {
   std::string ySignalName; // Signal for Y axis
   bool paused = false;
   bool isOpen = true;
+  bool visible = true; // On screen last frame (see IsCurrentWindowOccluded)
 
   // History of X/Y points with fade effect
   std::vector<double> historyX;
   std::vector<double> historyY;
-  int maxHistorySize = 500; // Number of points to keep
+  int maxHistorySize = 500; // Number of points to keep (trail length, up to 100k)
   int historyOffset = 0;
+  XYTrailCursor trailX; // Online: samples already added to the trail
+  XYTrailCursor trailY;
+
+  // Offline: Y is resampled onto X's timestamps (see signal_join.hpp)
+  JoinMode joinMode = JoinMode::Linear;
+  JoinCache join;
 
 };
 
@@ -52,8 +93,52 @@ struct HistogramWindow {
   std::string title;
   std::string signalName; // Single signal to display (empty if none assigned)
   bool isOpen = true;
+  bool visible = true; // On screen last frame (see IsCurrentWindowOccluded)
   int numBins = 50; // Number of histogram bins
 
+  // Bin counts kept across frames (see signal_histogram.hpp), updated on an
+  // analysis thread; the window draws the latest finished job's bars
+  AnalysisSlot<HistogramJob, IncrementalHistogram> analysis;
+
+};
+
+// One FFT window update (see analysis_jobs.hpp): settings and samples
+// captured on the UI thread, spectrum filled in by an analysis thread
+struct FFTJob {
+  const Signal* signal = nullptr; // Identity only; jobs never read the signal
+  uint32_t generation = 0;
+  uint64_t begin = 0; // Absolute sample range analyzed
+  uint64_t end = 0;
+  int fftSize = 0;
+  WindowType window = WindowType::Rectangular;
+  bool logScale = false;
+  bool welch = false;
+  float overlap = -1.0f;
+  bool parallel = false;
+  double fs = 0.0;
+  std::vector<double> values; // Samples [begin, end)
+
+  std::vector<double> freqBins;
+  std::vector<double> magnitude;
+  int welchSegments = 0; // Segments averaged into the PSD
+
+  size_t Bytes() const {
+    return (values.capacity() + freqBins.capacity() + magnitude.capacity()) * sizeof(double);
+  }
+};
+
+// FFT buffers an FFT window's jobs reuse
+struct FFTScratch {
+  FFTWorkspace workspace; // Aligned pffft buffers
+  std::vector<FFTWorkspace> slotWorkspaces; // Welch: FFT buffers per worker pool slot
+  std::vector<std::vector<double>> slotPower; // Welch: summed segment power per slot
+
+  size_t Bytes() const {
+    size_t bytes = workspace.Bytes();
+    for (const auto& ws : slotWorkspaces) bytes += ws.Bytes();
+    for (const auto& p : slotPower) bytes += p.capacity() * sizeof(double);
+    return bytes;
+  }
 };
 
 // Represents one FFT Plot (frequency domain analysis)
@@ -62,10 +147,21 @@ struct FFTWindow {
   std::string title;
   std::string signalName; // Single signal to display (empty if none assigned)
   bool isOpen = true;
+  bool visible = true; // On screen last frame (see IsCurrentWindowOccluded)
   int fftSize = 2048; // Number of samples for FFT (power of 2)
-  bool useHanning = true; // Apply Hanning window to reduce spectral leakage
+  WindowType window = WindowType::Hann; // Window function to reduce spectral leakage
   bool logScale = true; // Display magnitude in dB scale
+  bool welch = false; // Welch PSD: average overlapping segments over the whole buffer (V^2/Hz)
+  float welchOverlap = 0.5f; // Overlap between Welch segments (fraction of fftSize)
+  bool parallel = true; // Spread Welch segments over the worker pool
 
+  // Spectrum jobs: a new one is submitted only after enough new samples (or
+  // a settings change) and at most once per updateThrottleSeconds; the
+  // window draws the latest finished one
+  AnalysisSlot<FFTJob, FFTScratch> analysis;
+  double lastComputeTime = 0.0;
+  double updateThrottleSeconds = 0.1; // Minimum seconds between updates (10 FPS max)
+  static constexpr int kNewSampleDivisor = 8; // Streaming: wait for fftSize / 8 new samples
 };
 
 // Colormap types for spectrogram visualization
@@ -77,57 +173,113 @@ enum class Colormap {
   ImPlotDefault
 };
 
+// How a spectrogram maps magnitudes onto its colormap
+enum class SpectrogramRange {
+  Auto,       // Full min..max of the displayed columns
+  Percentile, // Between two percentiles, so a few outliers don't wash out the rest
+  Fixed       // User-set limits (e.g. -120..0 dB), stable while streaming
+};
+
+inline const char* SpectrogramRangeName(SpectrogramRange range) {
+  switch (range) {
+    case SpectrogramRange::Percentile: return "percentile";
+    case SpectrogramRange::Fixed: return "fixed";
+    default: return "auto";
+  }
+}
+
+inline SpectrogramRange SpectrogramRangeFromName(const std::string& name) {
+  if (name == "percentile") return SpectrogramRange::Percentile;
+  if (name == "fixed") return SpectrogramRange::Fixed;
+  return SpectrogramRange::Auto;
+}
+
+// One spectrogram update (see analysis_jobs.hpp). The UI thread plans the
+// column range to show and which columns are missing (PlanSpectrogram) and,
+// when its turn in the frame budget comes, copies their samples
+// (GatherSpectrogramInputs); an analysis thread transforms them; collecting
+// the job applies it to the window's column ring (ApplySpectrogramJob).
+struct SpectrogramJob {
+  const Signal* signal = nullptr; // Identity only; jobs never read the signal
+  uint32_t generation = 0;
+  int fftSize = 0;
+  int hopSize = 1;
+  WindowType window = WindowType::Rectangular;
+  bool logScale = false;
+  int maxFrequency = 0;
+  bool parallel = false;
+  double fs = 0.0;
+  int bins = 0;       // Magnitudes per column (0: not enough data, show nothing)
+  bool reset = false; // Settings changed: drop the old columns first
+  int64_t firstCol = 0; // Hop-grid columns to keep/show [firstCol, endCol)
+  int64_t endCol = 0;
+  std::vector<std::pair<int64_t, double>> pending; // Missing columns: hop index, center time
+  int64_t valuesBegin = 0; // values = absolute samples [valuesBegin, valuesBegin + size)
+  std::vector<double> values;
+
+  std::vector<double> mags; // pending.size() columns of `bins` magnitudes
+  bool failed = false;
+
+  size_t Bytes() const {
+    return (values.capacity() + mags.capacity()) * sizeof(double) +
+           pending.capacity() * sizeof(pending[0]);
+  }
+};
+
+// FFT buffers a spectrogram's jobs reuse
+struct SpectrogramScratch {
+  std::vector<FFTWorkspace> slotWorkspaces; // Aligned pffft buffers per worker pool slot
+
+  size_t Bytes() const {
+    size_t bytes = 0;
+    for (const auto& ws : slotWorkspaces) bytes += ws.Bytes();
+    return bytes;
+  }
+};
+
 // Represents one Spectrogram Plot (time-frequency visualization)
 struct SpectrogramWindow {
   int id;
   std::string title;
   std::string signalName; // Single signal to display (empty if none assigned)
   bool isOpen = true;
+  bool visible = true; // On screen last frame (see IsCurrentWindowOccluded)
   int fftSize = 512; // Number of samples per FFT window (power of 2)
   int hopSize = 256; // Number of samples to advance between FFT windows (default 50% overlap)
-  bool useHanning = true; // Apply Hanning window to reduce spectral leakage
+  WindowType window = WindowType::Hann; // Window function to reduce spectral leakage
   bool logScale = true; // Display magnitude in dB scale
   double timeWindow = 5.0; // Time duration to display (seconds)
   int maxFrequency = 0; // Maximum frequency to display (0 = auto, uses Nyquist/2)
   Colormap colormap = Colormap::Viridis; // Colormap selection
   bool useInterpolation = true; // Enable bilinear interpolation for smoother appearance
+  bool parallel = true; // Spread new hops over the worker pool
+  SpectrogramRange rangeMode = SpectrogramRange::Auto; // Color scale limits
+  float fixedMin = -120.0f; // Fixed range limits (magnitude units, dB when logScale)
+  float fixedMax = 0.0f;
+  float percentileLow = 5.0f; // Percentile range limits (0-100)
+  float percentileHigh = 99.5f;
 
 
 
-  // Cache for spectrogram computation (performance optimization)
-  std::vector<double> cachedTimeBins;
+  // Streaming STFT state: completed columns are kept between updates and only
+  // new hops are transformed, on an analysis thread (see PlanSpectrogram)
+  SpectrogramColumns columns;
   std::vector<double> cachedFreqBins;
-  std::vector<double> cachedMagnitudeMatrix;
-  std::vector<double> transposedMagnitudeMatrix; // Format: [freq][time] for ImPlot::PlotHeatmap
-  size_t cachedDataSize = 0; // Size of data when cache was computed
-  int cachedOffset = -1;     // Circular buffer offset when computed
-  double cachedWindowStart = -1.0; // Offline window start when computed
-  double cachedWindowWidth = -1.0; // Offline window width when computed
+  double magMin = 0.0; // Color scale limits, recomputed when the columns or range settings change
+  double magMax = 1.0;
+  std::vector<double> rangeScratch; // Sampled magnitudes for percentile ranges
+  const Signal* cachedSignal = nullptr;
+  uint32_t cachedGeneration = 0;
   int cachedFftSize = -1;
   int cachedHopSize = -1;
   bool cachedLogScale = false;
-  bool cachedUseHanning = false;
+  WindowType cachedWindow = WindowType::Rectangular;
   int cachedMaxFrequency = -1;
   double cachedFs = 0.0;
   double lastComputeTime = 0.0; // Time when last computed
   double updateThrottleSeconds = 0.1; // Minimum seconds between updates (10 FPS max)
 
-  // Worker buffers to avoid allocations in hot path
-  std::vector<double> analyzerData;
-  std::vector<double> analyzerTime;
-  std::vector<float> magnitudesFloat;
-  
-  // Aligned buffers for pffft (managed manually to ensure SIMD alignment)
-  float* pffft_work = nullptr;
-  float* pffft_output = nullptr;
-  float* pffft_input = nullptr;
-  int pffft_buffer_size = 0;
-
-  ~SpectrogramWindow() {
-    if (pffft_work) pffft_aligned_free(pffft_work);
-    if (pffft_output) pffft_aligned_free(pffft_output);
-    if (pffft_input) pffft_aligned_free(pffft_input);
-  }
+  AnalysisSlot<SpectrogramJob, SpectrogramScratch> analysis;
 };
 
 // -------------------------------------------------------------------------
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "signal_registry.hpp"
+#include "types.hpp"
+
+// -------------------------------------------------------------------------
+// SIGNAL MEMORY BUDGET
+// -------------------------------------------------------------------------
+// Every signal's sample storage is charged against one global byte budget.
+// Once usage passes compressAtPercent of the budget, old offline chunks are
+// Gorilla-compressed a few at a time each frame (lossless, see
+// signal_compression.hpp); below that nothing is encoded.
+//
+// Once per frame the budget is measured; when it is exceeded the enabled
+// policies run in order of how much history they give up:
+//
+//   1. Trim idle chunks out of the chunk pool
+//   2. Shrink the ring of online signals no window is showing
+//   3. Downsample old offline samples to min/max pairs
+//   4. Spill full offline chunks to a temporary memory-mapped file
+//
+// Online signals get their full ring back as soon as a window shows them.
+// Offline chunks in out-of-core column files are not charged: the OS page
+// cache already decides how much of them stays in RAM.
+
+class SignalMemoryBudget {
+public:
+  // Settings (edited from the Memory Profiler)
+  int budgetMB = 1024;
+  bool compressOffline = true;
+  int compressAtPercent = 50;        // Budget usage at which compression starts
+  int compressChunksPerFrame = 4;    // Bounds the encoding work per frame
+  int keepRawChunks = 4;             // Newest full chunks left uncompressed
+  bool shrinkInactive = true;
+  int inactiveHistory = 1000;        // Ring size for online signals nobody is viewing
+  bool downsampleOld = true;
+  int downsampleFactor = 16;         // Samples folded into one min/max pair
+  int keepRecentSamples = 1000000;   // Offline samples always kept at full rate
+  bool spillToDisk = true;
+
+  // Statistics (refreshed every Enforce)
+  size_t usedBytes = 0;
+  size_t spilledBytes = 0;
+  size_t mappedBytes = 0;            // Out-of-core column files (page cache, not heap)
+  size_t compressedChunks = 0;
+  size_t compressedBytes = 0;
+  size_t shrinkCount = 0;
+  size_t downsampleCount = 0;
+  size_t spillCount = 0;
+
+  size_t BudgetBytes() const { return (size_t)std::max(budgetMB, 1) * 1024 * 1024; }
+  float Pressure() const { return (float)((double)usedBytes / (double)BudgetBytes()); }
+
+  void Enforce(SignalRegistry& registry, const std::unordered_set<std::string>& active) {
+    // Give visible online signals their full history back
+    registry.ForEach([&](Signal& sig) {
+      if (sig.mode == PlaybackMode::ONLINE && sig.maxSize < sig.nominalSize && active.count(sig.name)) {
+        sig.ResizeHistory(sig.nominalSize);
+      }
+    });
+
+    Measure(registry);
+    if (compressOffline && usedBytes * 100 >= BudgetBytes() * (size_t)std::clamp(compressAtPercent, 0, 100)) {
+      size_t quota = (size_t)std::max(compressChunksPerFrame, 0);
+      size_t freed = 0;
+      registry.ForEach([&](Signal& sig) {
+        if (quota == 0) return;
+        size_t before = sig.chunks.CompressedChunks();
+        freed += sig.CompressHistory(quota, (size_t)std::max(keepRawChunks, 0));
+        quota -= std::min(quota, sig.chunks.CompressedChunks() - before);
+      });
+      usedBytes -= std::min(usedBytes, freed);
+    }
+    if (usedBytes <= BudgetBytes()) return;
+
+    // Evictions copy data around, so run them at most once per second
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastEviction < std::chrono::seconds(1)) return;
+    lastEviction = now;
+
+    GetSignalChunkPool().Trim(0);
+    Measure(registry);
+
+    if (shrinkInactive) {
+      registry.ForEach([&](Signal& sig) {
+        if (usedBytes <= BudgetBytes()) return;
+        if (sig.mode != PlaybackMode::ONLINE || active.count(sig.name) ||
+            sig.maxSize <= std::max(inactiveHistory, 1)) {
+          return;
+        }
+        size_t before = sig.MemoryBytes();
+        sig.ResizeHistory(std::max(inactiveHistory, 1));
+        usedBytes -= std::min(usedBytes, before - std::min(before, sig.MemoryBytes()));
+        shrinkCount++;
+      });
+      if (usedBytes <= BudgetBytes()) return;
+    }
+
+    // Offline signals, largest first
+    std::vector<Signal*> offline;
+    registry.ForEach([&](Signal& sig) {
+      if (sig.mode == PlaybackMode::OFFLINE) offline.push_back(&sig);
+    });
+    std::sort(offline.begin(), offline.end(),
+              [](const Signal* a, const Signal* b) { return a->MemoryBytes() > b->MemoryBytes(); });
+
+    if (downsampleOld) {
+      for (Signal* sig : offline) {
+        if (usedBytes <= BudgetBytes()) return;
+        size_t freed = sig->DownsampleOld((size_t)std::max(keepRecentSamples, 0),
+                                          (size_t)std::max(downsampleFactor, 4));
+        if (freed > 0) {
+          printf("[MemoryBudget] Downsampled %s (%.1f MB freed)\n", sig->name.c_str(),
+                 freed / (1024.0 * 1024.0));
+          usedBytes -= std::min(usedBytes, freed);
+          downsampleCount++;
+        }
+      }
+    }
+
+    if (spillToDisk) {
+      std::string dir = MappedFile::TempDirectory();
+      for (Signal* sig : offline) {
+        if (usedBytes <= BudgetBytes()) return;
+        size_t freed = sig->SpillToDisk(dir);
+        if (freed > 0) {
+          printf("[MemoryBudget] Spilled %s to disk (%.1f MB)\n", sig->name.c_str(),
+                 freed / (1024.0 * 1024.0));
+          usedBytes -= std::min(usedBytes, freed);
+          spilledBytes += freed;
+          spillCount++;
+        }
+      }
+    }
+  }
+
+private:
+  void Measure(const SignalRegistry& registry) {
+    size_t bytes = GetSignalChunkPool().IdleChunks() * sizeof(SignalChunk);
+    size_t spilled = 0;
+    size_t mapped = 0;
+    size_t packedChunks = 0;
+    size_t packedBytes = 0;
+    registry.ForEach([&](const Signal& sig) {
+      bytes += sig.MemoryBytes();
+      spilled += sig.SpilledBytes();
+      mapped += sig.MappedBytes();
+      packedChunks += sig.chunks.CompressedChunks();
+      packedBytes += sig.chunks.CompressedBytes();
+    });
+    usedBytes = bytes + GetDecodedChunkCache().MemoryBytes();
+    spilledBytes = spilled;
+    mappedBytes = mapped;
+    compressedChunks = packedChunks;
+    compressedBytes = packedBytes;
+  }
+
+  std::chrono::steady_clock::time_point lastEviction{};
+};
+
+inline SignalMemoryBudget& GetSignalMemoryBudget() {
+  static SignalMemoryBudget budget;
+  return budget;
+}
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// -------------------------------------------------------------------------
+// GORILLA-STYLE SAMPLE COMPRESSION
+// -------------------------------------------------------------------------
+// Lossless encoding for blocks of (time, value) samples, after Facebook's
+// Gorilla TSDB:
+//
+//   - Timestamps: delta-of-delta of the IEEE-754 bit patterns. Near-regular
+//     sampling gives a delta-of-delta of 0 or a few ulps -> 1 to 9 bits.
+//   - Values: XOR with the previous value; only the meaningful bits between
+//     the leading and trailing zeros are stored -> 1 bit for repeats, a few
+//     bits for slowly changing values.
+//
+// Blocks are decoded as a whole, so random access is per block.
+
+class BitWriter {
+public:
+  explicit BitWriter(std::vector<uint64_t>& out) : words(out) {}
+
+  void Write(uint64_t value, int bits) {
+    if (bits == 0) return;
+    if (bits < 64) value &= (1ULL << bits) - 1;
+    int free = 64 - used;
+    if (used == 0) words.push_back(0);
+    if (bits <= free) {
+      words.back() |= value << (free - bits);
+      used = (used + bits) & 63;
+    } else {
+      int rest = bits - free;
+      words.back() |= value >> rest;
+      words.push_back(value << (64 - rest));
+      used = rest;
+    }
+  }
+
+  void WriteBit(bool bit) { Write(bit ? 1 : 0, 1); }
+
+private:
+  std::vector<uint64_t>& words;
+  int used = 0; // Bits used in words.back() (0 = need a new word)
+};
+
+class BitReader {
+public:
+  explicit BitReader(const std::vector<uint64_t>& in) : words(in) {}
+
+  uint64_t Read(int bits) {
+    if (bits == 0) return 0;
+    uint64_t result = 0;
+    while (bits > 0) {
+      int avail = 64 - pos;
+      int take = bits < avail ? bits : avail;
+      uint64_t word = word_index < words.size() ? words[word_index] : 0;
+      uint64_t chunk = (word << pos) >> (64 - take);
+      result = (take == 64) ? chunk : ((result << take) | chunk);
+      bits -= take;
+      pos += take;
+      if (pos == 64) {
+        pos = 0;
+        word_index++;
+      }
+    }
+    return result;
+  }
+
+  bool ReadBit() { return Read(1) != 0; }
+
+private:
+  const std::vector<uint64_t>& words;
+  size_t word_index = 0;
+  int pos = 0;
+};
+
+inline uint64_t DoubleBits(double v) {
+  uint64_t bits;
+  std::memcpy(&bits, &v, sizeof(bits));
+  return bits;
+}
+
+inline double BitsDouble(uint64_t bits) {
+  double v;
+  std::memcpy(&v, &bits, sizeof(v));
+  return v;
+}
+
+inline int CountLeadingZeros64(uint64_t v) {
+  if (v == 0) return 64;
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanReverse64(&index, v);
+  return 63 - (int)index;
+#else
+  return __builtin_clzll(v);
+#endif
+}
+
+inline int CountTrailingZeros64(uint64_t v) {
+  if (v == 0) return 64;
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward64(&index, v);
+  return (int)index;
+#else
+  return __builtin_ctzll(v);
+#endif
+}
+
+// XOR value encoder/decoder state shared by both directions
+struct GorillaXorState {
+  uint64_t prev = 0;
+  int leading = -1; // Current meaningful-bit window (-1 = none yet)
+  int trailing = 0;
+};
+
+inline void GorillaWriteValue(BitWriter& w, GorillaXorState& s, uint64_t value) {
+  uint64_t x = value ^ s.prev;
+  s.prev = value;
+  if (x == 0) {
+    w.WriteBit(false);
+    return;
+  }
+  w.WriteBit(true);
+  int leading = CountLeadingZeros64(x);
+  int trailing = CountTrailingZeros64(x);
+  if (leading > 31) leading = 31;
+  if (s.leading >= 0 && leading >= s.leading && trailing >= s.trailing) {
+    // Fits in the previous window
+    w.WriteBit(false);
+    w.Write(x >> s.trailing, 64 - s.leading - s.trailing);
+    return;
+  }
+  int meaningful = 64 - leading - trailing;
+  w.WriteBit(true);
+  w.Write((uint64_t)leading, 5);
+  w.Write((uint64_t)(meaningful - 1), 6);
+  w.Write(x >> trailing, meaningful);
+  s.leading = leading;
+  s.trailing = trailing;
+}
+
+inline uint64_t GorillaReadValue(BitReader& r, GorillaXorState& s) {
+  if (!r.ReadBit()) return s.prev;
+  if (r.ReadBit()) {
+    s.leading = (int)r.Read(5);
+    int meaningful = (int)r.Read(6) + 1;
+    s.trailing = 64 - s.leading - meaningful;
+  }
+  int meaningful = 64 - s.leading - s.trailing;
+  uint64_t x = r.Read(meaningful) << s.trailing;
+  s.prev ^= x;
+  return s.prev;
+}
+
+// Delta-of-delta timestamp buckets (zigzag encoded): '0' | '10'+7 | '110'+9 | '1110'+12 | '1111'+64
+inline void GorillaWriteDod(BitWriter& w, int64_t dod) {
+  uint64_t zz = ((uint64_t)dod << 1) ^ (uint64_t)(dod >> 63);
+  if (zz == 0) {
+    w.WriteBit(false);
+  } else if (zz < (1ULL << 7)) {
+    w.Write(0b10, 2);
+    w.Write(zz, 7);
+  } else if (zz < (1ULL << 9)) {
+    w.Write(0b110, 3);
+    w.Write(zz, 9);
+  } else if (zz < (1ULL << 12)) {
+    w.Write(0b1110, 4);
+    w.Write(zz, 12);
+  } else {
+    w.Write(0b1111, 4);
+    w.Write(zz, 64);
+  }
+}
+
+inline int64_t GorillaReadDod(BitReader& r) {
+  uint64_t zz;
+  if (!r.ReadBit()) {
+    zz = 0;
+  } else if (!r.ReadBit()) {
+    zz = r.Read(7);
+  } else if (!r.ReadBit()) {
+    zz = r.Read(9);
+  } else if (!r.ReadBit()) {
+    zz = r.Read(12);
+  } else {
+    zz = r.Read(64);
+  }
+  return (int64_t)(zz >> 1) ^ -(int64_t)(zz & 1);
+}
+
+// Encode n samples into `out` (cleared first)
+inline void GorillaEncode(const double* x, const double* y, size_t n, std::vector<uint64_t>& out) {
+  out.clear();
+  if (n == 0) return;
+  BitWriter w(out);
+  GorillaXorState values;
+
+  uint64_t prevTime = DoubleBits(x[0]);
+  int64_t prevDelta = 0;
+  w.Write(prevTime, 64);
+  values.prev = DoubleBits(y[0]);
+  w.Write(values.prev, 64);
+
+  for (size_t i = 1; i < n; i++) {
+    uint64_t t = DoubleBits(x[i]);
+    int64_t delta = (int64_t)(t - prevTime);
+    GorillaWriteDod(w, (int64_t)((uint64_t)delta - (uint64_t)prevDelta));
+    prevDelta = delta;
+    prevTime = t;
+    GorillaWriteValue(w, values, DoubleBits(y[i]));
+  }
+}
+
+// Decode n samples produced by GorillaEncode
+inline void GorillaDecode(const std::vector<uint64_t>& in, size_t n, double* x, double* y) {
+  if (n == 0) return;
+  BitReader r(in);
+  GorillaXorState values;
+
+  uint64_t prevTime = r.Read(64);
+  int64_t prevDelta = 0;
+  values.prev = r.Read(64);
+  x[0] = BitsDouble(prevTime);
+  y[0] = BitsDouble(values.prev);
+
+  for (size_t i = 1; i < n; i++) {
+    int64_t delta = (int64_t)((uint64_t)prevDelta + (uint64_t)GorillaReadDod(r));
+    prevTime += (uint64_t)delta;
+    prevDelta = delta;
+    x[i] = BitsDouble(prevTime);
+    y[i] = BitsDouble(GorillaReadValue(r, values));
+  }
+}
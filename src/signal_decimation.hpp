@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "types.hpp"
+
+// -------------------------------------------------------------------------
+// M4 LINE DECIMATION
+// -------------------------------------------------------------------------
+// A line plot can't show more than one x position per pixel column, so a
+// series is reduced to the points that decide what each column looks like:
+// the first, minimum, maximum and last sample that fall in it (M4, Jugel et
+// al. 2014). Drawing those in time order rasterizes the same as drawing
+// every sample, with at most 4 points per column.
+//
+// Long ranges are first thinned through the signal's min/max LOD pyramid at
+// a few buckets per column, so the cost follows the pixel width instead of
+// the sample count. Extremes stay exact; first/last of a column can move by
+// up to one bucket. Results are cached per plotted line until the axis range,
+// plot width or signal contents change.
+
+class M4Builder {
+public:
+  M4Builder(double xMin, double xMax, size_t columns, std::vector<double>& outX, std::vector<double>& outY)
+      : xMin(xMin), scale(xMax > xMin ? (double)columns / (xMax - xMin) : 0.0), outX(outX), outY(outY) {}
+
+  ~M4Builder() { Flush(); }
+
+  void Add(double x, double y) {
+    int64_t column = (int64_t)std::floor((x - xMin) * scale);
+    if (n == 0 || column != currentColumn) {
+      Flush();
+      currentColumn = column;
+      first = min = max = last = Point{x, y, 0};
+      n = 1;
+      return;
+    }
+    Point p{x, y, n++};
+    if (y < min.y) min = p;
+    if (y > max.y) max = p;
+    last = p;
+  }
+
+  // Emit the current column's points in arrival order, without duplicates
+  void Flush() {
+    if (n == 0) return;
+    const Point* pts[4] = {&first, &min, &max, &last};
+    if (max.seq < min.seq) std::swap(pts[1], pts[2]);
+    uint64_t emitted = UINT64_MAX;
+    for (const Point* p : pts) {
+      if (p->seq == emitted) continue;
+      outX.push_back(p->x);
+      outY.push_back(p->y);
+      emitted = p->seq;
+    }
+    n = 0;
+  }
+
+private:
+  struct Point {
+    double x, y;
+    uint64_t seq; // Position within the column
+  };
+
+  double xMin;
+  double scale; // Columns per x unit
+  std::vector<double>& outX;
+  std::vector<double>& outY;
+  int64_t currentColumn = 0;
+  uint64_t n = 0;
+  Point first{}, min{}, max{}, last{};
+};
+
+// Decimated copy of one plotted series, reused while nothing changed
+class DecimatedLine {
+public:
+  static constexpr size_t kPointsPerColumn = 4;
+  // Pyramid budget fed into M4. Levels are 16x apart, so a budget of 16
+  // buckets per column always picks a level with at least one per column.
+  static constexpr size_t kBucketsPerColumn = 16;
+
+  // Reduce samples [first, first + count) for an x range drawn `columns`
+  // pixels wide. Returns false when the raw samples are already small
+  // enough to draw directly (X()/Y() are then not updated).
+  bool Decimate(const Signal& sig, size_t first, size_t count, double xMin, double xMax, size_t columns) {
+    if (columns == 0 || count <= columns * kPointsPerColumn) return false;
+
+    Key key{&sig, sig.generation, sig.totalCount, first, count, xMin, xMax, columns};
+    if (valid && key == cached) return true;
+
+    x.clear();
+    y.clear();
+    {
+      M4Builder m4(xMin, xMax, columns, x, y);
+      scratchX.clear();
+      scratchY.clear();
+      if (sig.DecimateMinMax(first, count, columns * kBucketsPerColumn, scratchX, scratchY)) {
+        for (size_t i = 0; i < scratchX.size(); i++) m4.Add(scratchX[i], scratchY[i]);
+      } else {
+        sig.ForEachSpan(first, count, [&](const double* px, const double* py, size_t n) {
+          for (size_t i = 0; i < n; i++) m4.Add(px[i], py[i]);
+        });
+      }
+    }
+    cached = key;
+    valid = true;
+    return true;
+  }
+
+  void Invalidate() { valid = false; }
+
+  const double* X() const { return x.data(); }
+  const double* Y() const { return y.data(); }
+  int Size() const { return (int)x.size(); }
+
+private:
+  struct Key {
+    const Signal* sig;
+    uint32_t generation;
+    uint64_t totalCount;
+    size_t first;
+    size_t count;
+    double xMin;
+    double xMax;
+    size_t columns;
+
+    bool operator==(const Key& o) const {
+      return sig == o.sig && generation == o.generation && totalCount == o.totalCount &&
+             first == o.first && count == o.count && xMin == o.xMin && xMax == o.xMax &&
+             columns == o.columns;
+    }
+  };
+
+  std::vector<double> x, y;
+  std::vector<double> scratchX, scratchY; // Pyramid output
+  Key cached{};
+  bool valid = false;
+};
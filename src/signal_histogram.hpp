@@ -0,0 +1,232 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "types.hpp"
+
+// -------------------------------------------------------------------------
+// INCREMENTAL HISTOGRAM
+// -------------------------------------------------------------------------
+// Bin counts kept across frames for one histogram window. Each update only
+// touches samples that changed since the last one:
+//
+//   - new samples at the end are added
+//   - samples the online ring evicted are subtracted (their values are gone
+//     by then, so the bin each counted sample went into is remembered)
+//   - offline, moving the time window back subtracts the samples past its
+//     end (still in storage, so they are simply re-binned and removed)
+//
+// The bin range is the signal's min/max (from its running statistics) with
+// a little headroom. Everything is re-binned only when the data leaves that
+// range, the data range shrinks to under half of it, numBins changes, or the
+// signal is cleared/re-laid out.
+//
+// Updates run as analysis jobs (analysis_jobs.hpp) in two steps: Plan() on
+// the UI thread decides what changes and copies just the samples that have
+// to be (re)counted into a HistogramUpdate, and Apply() on an analysis
+// thread does the counting without touching the signal.
+
+// What one update changes, captured by IncrementalHistogram::Plan
+struct HistogramUpdate {
+  const Signal* source = nullptr; // Identity only, never dereferenced by Apply
+  uint32_t generation = 0;
+  int numBins = 1;
+  RunningStats stats;
+  bool online = true;
+  size_t ringSize = 0;      // Online: sample capacity (evicted-bin ring length)
+  uint64_t base = 0;        // Absolute index of logical sample 0
+  uint64_t targetEnd = 0;   // Count absolute samples [base, targetEnd)
+  bool rebuild = false;
+  uint64_t valuesBegin = 0; // values = samples [valuesBegin, valuesBegin + size)
+  std::vector<double> values;
+};
+
+class IncrementalHistogram {
+public:
+  static constexpr double kHeadroom = 0.05; // Range padding on each side, relative to the data span
+
+  // UI thread: what bringing the counts in line with logical samples
+  // [0, count) of sig takes. False if nothing changed.
+  bool Plan(const Signal& sig, size_t count, int numBins, HistogramUpdate& u) const {
+    numBins = std::max(numBins, 1);
+    count = std::min(count, sig.Size());
+    u.source = &sig;
+    u.generation = sig.generation;
+    u.numBins = numBins;
+    u.stats = sig.Stats(true);
+    u.online = sig.mode == PlaybackMode::ONLINE;
+    u.ringSize = std::max<size_t>((size_t)sig.maxSize, 1);
+    u.base = sig.totalCount - sig.Size();
+    u.targetEnd = u.base + count;
+    u.rebuild = source != &sig || generation != sig.generation || numBins != (int)counts.size() ||
+                !RangeFits(u.stats) || (u.base > begin && evicted.empty());
+    u.values.clear();
+
+    if (u.rebuild) {
+      u.valuesBegin = u.base;
+      CopyValues(sig, 0, count, u.values);
+      return true;
+    }
+
+    // Apply() first drops what the ring evicted, then moves the end: only
+    // the samples between the old and new end are read
+    bool evicting = u.base > begin;
+    uint64_t from = evicting ? std::max(end, u.base) : end;
+    if (from == u.targetEnd) return evicting;
+    u.valuesBegin = std::min(from, u.targetEnd);
+    uint64_t to = std::max(from, u.targetEnd);
+    CopyValues(sig, (size_t)(u.valuesBegin - u.base), (size_t)(to - u.valuesBegin), u.values);
+    return true;
+  }
+
+  // Analysis thread: apply a planned update
+  void Apply(const HistogramUpdate& u) {
+    if (u.rebuild) {
+      Rebuild(u);
+      return;
+    }
+
+    // Samples the ring dropped since the last update
+    if (u.base > begin) {
+      uint64_t gone = std::min(u.base, end);
+      for (uint64_t a = begin; a < gone; a++) Subtract(evicted[a % evicted.size()]);
+      begin = u.base;
+      end = std::max(end, begin);
+    }
+
+    // Offline window moved back: drop the samples past the new end
+    if (end > u.targetEnd) {
+      for (double v : u.values) Subtract(BinOf(v));
+      end = u.targetEnd;
+    }
+
+    // New samples
+    if (end < u.targetEnd) {
+      Append(u.values.data(), u.values.size(), end);
+      end = u.targetEnd;
+    }
+  }
+
+  void Invalidate() { source = nullptr; }
+
+  // Bar positions/heights for ImPlot::PlotBars
+  const double* Centers() const { return centers.data(); }
+  const double* Counts() const { return counts.data(); }
+  int Bins() const { return (int)counts.size(); }
+  double BinWidth() const { return width; }
+  uint64_t Total() const { return total; }
+
+  size_t Bytes() const {
+    return (counts.capacity() + centers.capacity()) * sizeof(double) + evicted.capacity() * sizeof(uint16_t);
+  }
+
+private:
+  static constexpr uint16_t kNoBin = 0xFFFF; // NaN samples are not counted
+
+  static void CopyValues(const Signal& sig, size_t first, size_t n, std::vector<double>& out) {
+    out.reserve(n);
+    sig.ForEachSpan(first, n, [&](const double*, const double* y, size_t len) {
+      out.insert(out.end(), y, y + len);
+    });
+  }
+
+  // Range this data should be binned over (padded min/max)
+  static void IdealRange(const RunningStats& st, double& lo, double& hi) {
+    double span = st.max - st.min;
+    double pad = span > 0.0 ? span * kHeadroom : 0.5;
+    lo = st.min - pad;
+    hi = st.max + pad;
+  }
+
+  bool RangeFits(const RunningStats& st) const {
+    if (st.count == 0) return total == 0;
+    double idealLo, idealHi;
+    IdealRange(st, idealLo, idealHi);
+    return st.min >= lo && st.max <= hi && (hi - lo) <= 2.0 * (idealHi - idealLo);
+  }
+
+  void Rebuild(const HistogramUpdate& u) {
+    source = u.source;
+    generation = u.generation;
+    if (u.stats.count > 0) {
+      IdealRange(u.stats, lo, hi);
+    } else {
+      lo = 0.0;
+      hi = 1.0;
+    }
+    width = (hi - lo) / u.numBins;
+    counts.assign(u.numBins, 0.0);
+    centers.resize(u.numBins);
+    for (int b = 0; b < u.numBins; b++) centers[b] = lo + (b + 0.5) * width;
+    total = 0;
+
+    // Online samples can be evicted before we see them again: remember their bins
+    evicted.assign(u.online ? u.ringSize : 0, kNoBin);
+
+    begin = end = u.base;
+    Append(u.values.data(), u.values.size(), u.base);
+    end = u.targetEnd;
+  }
+
+  // Count y[0, n), absolute samples [a, a + n)
+  void Append(const double* y, size_t n, uint64_t a) {
+    for (size_t i = 0; i < n; i++, a++) {
+      uint16_t bin = BinOf(y[i]);
+      if (bin != kNoBin) {
+        counts[bin] += 1.0;
+        total++;
+      }
+      if (!evicted.empty()) evicted[a % evicted.size()] = bin;
+    }
+  }
+
+  void Subtract(uint16_t bin) {
+    if (bin == kNoBin) return;
+    counts[bin] -= 1.0;
+    total--;
+  }
+
+  uint16_t BinOf(double v) const {
+    if (std::isnan(v) || width <= 0.0) return kNoBin;
+    double b = std::floor((v - lo) / width);
+    int last = (int)counts.size() - 1;
+    return (uint16_t)std::min(std::max(b, 0.0), (double)last);
+  }
+
+  const Signal* source = nullptr;
+  uint32_t generation = 0;
+  double lo = 0.0;
+  double hi = 1.0;
+  double width = 0.0;
+  uint64_t begin = 0; // Absolute sample range currently counted
+  uint64_t end = 0;
+  uint64_t total = 0;
+  std::vector<double> counts;
+  std::vector<double> centers;
+  std::vector<uint16_t> evicted; // Online: bin of absolute sample a at a % size()
+};
+
+// One histogram window update: the plan, and the bars it produced
+struct HistogramJob {
+  HistogramUpdate update;
+  std::vector<double> centers;
+  std::vector<double> counts;
+  double binWidth = 0.0;
+  uint64_t total = 0;
+
+  size_t Bytes() const {
+    return (update.values.capacity() + centers.capacity() + counts.capacity()) * sizeof(double);
+  }
+};
+
+inline void RunHistogramJob(HistogramJob& job, IncrementalHistogram& bins) {
+  bins.Apply(job.update);
+  job.centers.assign(bins.Centers(), bins.Centers() + bins.Bins());
+  job.counts.assign(bins.Counts(), bins.Counts() + bins.Bins());
+  job.binWidth = bins.BinWidth();
+  job.total = bins.Total();
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "types.hpp"
+
+// -------------------------------------------------------------------------
+// TIME-ALIGNED SIGNAL JOIN
+// -------------------------------------------------------------------------
+// Signals from different packets have their own timestamps, so pairing them
+// by sample index (X/Y plots, correlation, derived signals) mixes values from
+// different instants. The join walks the reference signal's samples in a time
+// window and resamples the other signal at each reference timestamp:
+//
+//   - Nearest: value of the closest sample in time
+//   - Hold:    most recent sample at or before t (sample-and-hold)
+//   - Linear:  interpolated between the samples around t
+//
+// Both time columns are sorted, so this is a merge join: one cursor per
+// signal, each moving forward only -> O(n + m) per window.
+
+enum class JoinMode {
+  Nearest,
+  Hold,
+  Linear
+};
+
+inline const char* JoinModeName(JoinMode mode) {
+  switch (mode) {
+    case JoinMode::Hold: return "hold";
+    case JoinMode::Linear: return "linear";
+    default: return "nearest";
+  }
+}
+
+inline JoinMode JoinModeFromName(const std::string& name) {
+  if (name == "hold") return JoinMode::Hold;
+  if (name == "linear") return JoinMode::Linear;
+  return JoinMode::Nearest;
+}
+
+// Reference timestamps with both signals' values at those instants
+struct AlignedSpan {
+  std::vector<double> t;
+  std::vector<double> a; // Reference signal
+  std::vector<double> b; // Resampled signal
+
+  void Clear() {
+    t.clear();
+    a.clear();
+    b.clear();
+  }
+
+  void Push(double time, double va, double vb) {
+    t.push_back(time);
+    a.push_back(va);
+    b.push_back(vb);
+  }
+
+  size_t Size() const { return t.size(); }
+  bool Empty() const { return t.empty(); }
+};
+
+// Forward-only resampler over one signal. Query times must be non-decreasing;
+// an earlier time re-seeks with a binary search.
+class SignalResampler {
+public:
+  SignalResampler(const Signal& sig, JoinMode mode) : sig(sig), mode(mode), size(sig.Size()) {}
+
+  // Value at time t; false when t is outside what the mode can answer
+  bool At(double t, double& value) {
+    if (size == 0) return false;
+    if (!positioned || t < lastTime) {
+      next = sig.UpperBound(t);
+      positioned = true;
+    } else {
+      while (next < size && sig.XAt(next) <= t) next++;
+    }
+    lastTime = t;
+
+    // Samples [0, next) are at or before t, [next, size) after it
+    bool hasPrev = next > 0;
+    bool hasNext = next < size;
+    switch (mode) {
+      case JoinMode::Hold:
+        if (!hasPrev) return false;
+        value = sig.YAt(next - 1);
+        return true;
+
+      case JoinMode::Linear: {
+        if (!hasPrev) return false;
+        double t0 = sig.XAt(next - 1);
+        if (!hasNext) {
+          // No extrapolation past the last sample
+          if (t0 != t) return false;
+          value = sig.YAt(next - 1);
+          return true;
+        }
+        double t1 = sig.XAt(next);
+        double y0 = sig.YAt(next - 1);
+        double y1 = sig.YAt(next);
+        value = y0 + (y1 - y0) * (t - t0) / (t1 - t0); // t1 > t >= t0
+        return true;
+      }
+
+      default:
+        if (!hasPrev) {
+          value = sig.YAt(next);
+        } else if (!hasNext || t - sig.XAt(next - 1) <= sig.XAt(next) - t) {
+          value = sig.YAt(next - 1);
+        } else {
+          value = sig.YAt(next);
+        }
+        return true;
+    }
+  }
+
+private:
+  const Signal& sig;
+  JoinMode mode;
+  size_t size;
+  size_t next = 0; // First index with time > lastTime
+  double lastTime = 0.0;
+  bool positioned = false;
+};
+
+// Align `other` to `ref`'s samples with t0 <= t <= t1. Returns the pair count.
+inline size_t JoinSignals(const Signal& ref, const Signal& other, double t0, double t1,
+                          JoinMode mode, AlignedSpan& out) {
+  out.Clear();
+  if (ref.Empty() || other.Empty()) return 0;
+
+  size_t begin = 0;
+  size_t end = ref.Size();
+  if (ref.IsMonotonic()) {
+    begin = ref.LowerBound(t0);
+    end = std::max(begin, ref.UpperBound(t1));
+  }
+
+  SignalResampler resampler(other, mode);
+  ref.ForEachSpan(begin, end - begin, [&](const double* x, const double* y, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+      if (x[i] < t0 || x[i] > t1) continue;
+      double value;
+      if (resampler.At(x[i], value)) out.Push(x[i], y[i], value);
+    }
+  });
+  return out.Size();
+}
+
+// Pearson correlation of the aligned pairs (0 when undefined)
+inline double AlignedCorrelation(const AlignedSpan& span) {
+  size_t n = span.Size();
+  if (n < 2) return 0.0;
+  double meanA = 0.0, meanB = 0.0;
+  for (size_t i = 0; i < n; i++) {
+    meanA += span.a[i];
+    meanB += span.b[i];
+  }
+  meanA /= (double)n;
+  meanB /= (double)n;
+
+  double cov = 0.0, varA = 0.0, varB = 0.0;
+  for (size_t i = 0; i < n; i++) {
+    double da = span.a[i] - meanA;
+    double db = span.b[i] - meanB;
+    cov += da * db;
+    varA += da * da;
+    varB += db * db;
+  }
+  double denom = std::sqrt(varA * varB);
+  return denom > 0.0 ? cov / denom : 0.0;
+}
+
+// Last join result, recomputed only when the window, the mode or either
+// signal's contents change
+class JoinCache {
+public:
+  // Returns true if the span was recomputed
+  bool Update(const Signal& ref, const Signal& other, double t0, double t1, JoinMode mode) {
+    Key key{&ref, &other, ref.generation, other.generation, ref.totalCount, other.totalCount, t0, t1, mode};
+    if (valid && key == cached) return false;
+    JoinSignals(ref, other, t0, t1, mode, span);
+    correlation = AlignedCorrelation(span);
+    cached = key;
+    valid = true;
+    return true;
+  }
+
+  void Invalidate() {
+    valid = false;
+    span.Clear();
+    correlation = 0.0;
+  }
+
+  const AlignedSpan& Span() const { return span; }
+  double Correlation() const { return correlation; }
+  bool Valid() const { return valid; }
+
+private:
+  struct Key {
+    const Signal* ref;
+    const Signal* other;
+    uint32_t refGeneration;
+    uint32_t otherGeneration;
+    uint64_t refCount;
+    uint64_t otherCount;
+    double t0;
+    double t1;
+    JoinMode mode;
+
+    bool operator==(const Key& o) const {
+      return ref == o.ref && other == o.other && refGeneration == o.refGeneration &&
+             otherGeneration == o.otherGeneration && refCount == o.refCount &&
+             otherCount == o.otherCount && t0 == o.t0 && t1 == o.t1 && mode == o.mode;
+    }
+  };
+
+  AlignedSpan span;
+  double correlation = 0.0;
+  Key cached{};
+  bool valid = false;
+};
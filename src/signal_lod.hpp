@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// -------------------------------------------------------------------------
+// MIN/MAX LOD PYRAMID
+// -------------------------------------------------------------------------
+// Per-signal multi-resolution summary used to draw zoomed-out plots with a
+// bounded number of points. Level L groups kLodFactors[L] consecutive samples
+// into one bucket holding the minimum and maximum sample (with their
+// timestamps), so a decimated line still shows every spike.
+//
+// Buckets are addressed by absolute sample index (samples added since the
+// last reset), which keeps them stable while the online ring buffer wraps.
+// Online signals keep the buckets in a small ring sized to the sample ring;
+// offline signals keep all of them.
+
+constexpr int kLodLevels = 3;
+constexpr uint64_t kLodFactors[kLodLevels] = {16, 256, 4096};
+
+struct LodBucket {
+  double xMin, yMin; // Sample with the smallest value
+  double xMax, yMax; // Sample with the largest value
+};
+
+class MinMaxPyramid {
+public:
+  // ringSamples: capacity of the sample ring (0 = unbounded, offline)
+  void Reset(size_t ringSamples) {
+    for (int level = 0; level < kLodLevels; level++) {
+      std::vector<LodBucket>& buckets = levels[level];
+      buckets.clear();
+      if (ringSamples > 0) {
+        // +2 covers the partially filled buckets at both ends of the ring
+        ringBuckets[level] = ringSamples / kLodFactors[level] + 2;
+        buckets.resize(ringBuckets[level]);
+      } else {
+        ringBuckets[level] = 0;
+        buckets.shrink_to_fit();
+      }
+    }
+  }
+
+  // Fold sample number absIndex into every level (a few compares per level)
+  void Add(uint64_t absIndex, double x, double y) {
+    for (int level = 0; level < kLodLevels; level++) {
+      uint64_t b = absIndex / kLodFactors[level];
+      bool first = (absIndex % kLodFactors[level]) == 0;
+      if (ringBuckets[level] == 0 && first) {
+        levels[level].push_back(LodBucket{x, y, x, y});
+        continue;
+      }
+      LodBucket& bucket = Slot(level, b);
+      if (first) {
+        bucket = LodBucket{x, y, x, y};
+      } else {
+        if (y < bucket.yMin) { bucket.yMin = y; bucket.xMin = x; }
+        if (y > bucket.yMax) { bucket.yMax = y; bucket.xMax = x; }
+      }
+    }
+  }
+
+  // Finest level whose bucket count over `count` samples fits in maxBuckets
+  // Returns -1 when the raw samples already fit.
+  int ChooseLevel(uint64_t count, uint64_t maxBuckets) const {
+    if (count <= maxBuckets * 2) return -1;
+    for (int level = 0; level < kLodLevels; level++) {
+      if (count / kLodFactors[level] <= maxBuckets) return level;
+    }
+    return kLodLevels - 1;
+  }
+
+  const LodBucket& Bucket(int level, uint64_t b) const {
+    return ringBuckets[level] ? levels[level][b % ringBuckets[level]] : levels[level][b];
+  }
+
+  size_t MemoryBytes() const {
+    size_t bytes = 0;
+    for (const auto& buckets : levels) bytes += buckets.capacity() * sizeof(LodBucket);
+    return bytes;
+  }
+
+private:
+  LodBucket& Slot(int level, uint64_t b) {
+    return ringBuckets[level] ? levels[level][b % ringBuckets[level]] : levels[level][b];
+  }
+
+  std::vector<LodBucket> levels[kLodLevels];
+  size_t ringBuckets[kLodLevels] = {0, 0, 0};
+};
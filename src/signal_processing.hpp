@@ -3,12 +3,16 @@
 #include "imgui.h"
 #include "plot_types.hpp"
 #include "pffft.h"
+#include "worker_pool.hpp"
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <cstring>
+#include <limits>
 #include <vector>
 #include <memory>
 #include <map>
+#include <mutex>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -36,8 +40,11 @@ inline std::map<int, PFFTSetupPtr>& GetPFFTSetupCache() {
   return cache;
 }
 
-// Get or create cached pffft setup for given size
+// Get or create cached pffft setup for given size (analysis threads call
+// this concurrently; a setup is read-only once created)
 inline PFFFT_Setup* GetCachedPFFTSetup(int N) {
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
   auto& cache = GetPFFTSetupCache();
   auto it = cache.find(N);
 
@@ -53,41 +60,6 @@ inline PFFFT_Setup* GetCachedPFFTSetup(int N) {
   return setup;
 }
 
-// Calculate average sampling frequency from time points
-inline double CalculateSamplingFrequency(const std::vector<double>& timePoints, int startIdx, int numSamples) {
-  if (numSamples < 2 || startIdx + numSamples > (int)timePoints.size()) {
-    return 1.0; // Default fallback
-  }
-
-  // Calculate average time delta
-  double totalDelta = 0.0;
-  int deltaCount = 0;
-
-  for (int i = startIdx; i < startIdx + numSamples - 1; i++) {
-    double delta = timePoints[i + 1] - timePoints[i];
-    if (delta > 0.0) { // Only count positive deltas
-      totalDelta += delta;
-      deltaCount++;
-    }
-  }
-
-  if (deltaCount > 0) {
-    double avgDelta = totalDelta / deltaCount;
-    return 1.0 / avgDelta; // Sampling frequency = 1 / average period
-  }
-
-  return 1.0; // Fallback
-}
-
-// Apply Hanning window to reduce spectral leakage (operates on float for pffft)
-inline void ApplyHanningWindow(std::vector<float>& data) {
-  int N = data.size();
-  for (int i = 0; i < N; i++) {
-    float window = 0.5f * (1.0f - cosf(2.0f * M_PI * i / (N - 1)));
-    data[i] *= window;
-  }
-}
-
 // Optimized FFT using pffft library (SIMD-accelerated)
 // Version that uses pre-allocated buffers for maximum performance in loops
 inline void ComputeRealFFT_Direct(PFFFT_Setup* setup, float* inputCopy, float* output, float* work, std::vector<float>& magnitudes) {
@@ -111,102 +83,77 @@ inline void ComputeRealFFT_Direct(PFFFT_Setup* setup, float* inputCopy, float* o
   }
 }
 
-// Optimized FFT using pffft library (SIMD-accelerated)
-// Input: real-valued signal in 'input' (size N)
-// Returns magnitude spectrum (first N/2 bins only, since input is real)
-inline void ComputeRealFFT(const std::vector<float>& input, std::vector<float>& magnitudes) {
-  int N = input.size();
-
-  // pffft requires N >= 32 and power of 2
+// Magnitude spectrum of the workspace input (N samples, already windowed)
+// into ws.magnitudes. N must be >= 32 and a power of 2 (pffft requirement).
+inline bool ComputeRealFFT(FFTWorkspace& ws, int N) {
   if (N < 32 || (N & (N - 1)) != 0) {
     fprintf(stderr, "pffft FFT size must be >= 32 and power of 2, got %d\n", N);
-    magnitudes.clear();
-    return;
+    return false;
   }
 
   // Get cached pffft setup
   PFFFT_Setup* setup = GetCachedPFFTSetup(N);
-  if (!setup) {
-    magnitudes.clear();
-    return;
-  }
-
-  // Use pffft_aligned_malloc for proper SIMD alignment
-  float* work = (float*)pffft_aligned_malloc(N * sizeof(float));
-  float* output = (float*)pffft_aligned_malloc(N * sizeof(float));
-  float* inputCopy = (float*)pffft_aligned_malloc(N * sizeof(float));
+  if (!setup) return false;
 
-  // Copy input data
-  memcpy(inputCopy, input.data(), N * sizeof(float));
-
-  magnitudes.resize(N / 2);
-  ComputeRealFFT_Direct(setup, inputCopy, output, work, magnitudes);
-
-  // Free aligned memory
-  pffft_aligned_free(work);
-  pffft_aligned_free(output);
-  pffft_aligned_free(inputCopy);
+  ComputeRealFFT_Direct(setup, ws.input.Data(), ws.output.Data(), ws.work.Data(), ws.magnitudes);
+  return true;
 }
 
-// Compute FFT magnitude spectrum from signal data using pffft
-// Returns frequency bins and magnitude values
-inline void ComputeFFTSpectrum(const std::vector<double>& signalData,
-                       const std::vector<double>& timePoints,
-                       int fftSize,
-                       bool useHanning,
-                       bool logScale,
-                       std::vector<double>& freqBins,
-                       std::vector<double>& magnitude) {
-
-  if (signalData.size() < (size_t)fftSize) {
-    // Not enough data
-    freqBins.clear();
-    magnitude.clear();
-    return;
-  }
+// Compute the FFT magnitude spectrum of the last fftSize samples of
+// job.values into job.freqBins/job.magnitude. Samples are converted straight
+// into the aligned input buffer, so nothing is allocated once the workspace
+// is sized.
+inline void ComputeFFTSpectrum(FFTJob& job, FFTWorkspace& ws) {
+  int fftSize = job.fftSize;
+  std::vector<double>& freqBins = job.freqBins;
+  std::vector<double>& magnitude = job.magnitude;
+  size_t count = job.values.size();
 
   // pffft requires N >= 32 and power of 2
-  if (fftSize < 32 || (fftSize & (fftSize - 1)) != 0) {
+  if (count < (size_t)fftSize || fftSize < 32 || (fftSize & (fftSize - 1)) != 0 ||
+      !ws.Prepare(fftSize)) {
+    // Not enough data (or an unusable size)
     freqBins.clear();
     magnitude.clear();
     return;
   }
 
-  // Calculate sampling frequency
-  double fs = CalculateSamplingFrequency(timePoints, 0, std::min(fftSize, (int)timePoints.size()));
+  // Use the most recent samples, converted to float for pffft
+  const double* y = job.values.data() + (count - fftSize);
+  float* input = ws.input.Data();
+  for (int i = 0; i < fftSize; i++) input[i] = static_cast<float>(y[i]);
 
-  // Prepare data for FFT (use most recent samples) - convert to float for pffft
-  int startIdx = signalData.size() - fftSize;
-  std::vector<float> windowedData(fftSize);
-  for (int i = 0; i < fftSize; i++) {
-    windowedData[i] = static_cast<float>(signalData[startIdx + i]);
-  }
-
-  // Apply window function if requested
-  if (useHanning) {
-    ApplyHanningWindow(windowedData);
+  // Apply the window function (cached coefficient table)
+  const WindowTable* window = GetWindowTable(job.window, fftSize);
+  if (job.window != WindowType::Rectangular) {
+    MultiplyFloats(input, window->coeffs.data(), fftSize);
   }
 
   // Perform FFT using pffft
-  std::vector<float> magnitudesFloat;
-  ComputeRealFFT(windowedData, magnitudesFloat);
+  if (!ComputeRealFFT(ws, fftSize)) {
+    freqBins.clear();
+    magnitude.clear();
+    return;
+  }
+  const std::vector<float>& magnitudesFloat = ws.magnitudes;
 
   // Extract magnitude spectrum (only first half, since FFT is symmetric for real signals)
   int numFreqBins = fftSize / 2;
   freqBins.resize(numFreqBins);
   magnitude.resize(numFreqBins);
 
-  double freqResolution = fs / fftSize;
+  double freqResolution = job.fs / fftSize;
 
   for (int i = 0; i < numFreqBins; i++) {
     freqBins[i] = i * freqResolution;
     double mag = static_cast<double>(magnitudesFloat[i]);
 
-    // Normalize by FFT size
-    mag = mag / fftSize;
+    // Normalize by FFT size, corrected for the window's coherent gain so a
+    // tone reads the same magnitude with every window
+    mag = mag * window->amplitudeCorrection / fftSize;
 
     // Convert to dB if requested
-    if (logScale) {
+    if (job.logScale) {
       // Add small epsilon to avoid log(0)
       const double epsilon = 1e-10;
       magnitude[i] = 20.0 * log10(mag + epsilon);
@@ -216,6 +163,111 @@ inline void ComputeFFTSpectrum(const std::vector<double>& signalData,
   }
 }
 
+// Welch power spectral density of job.values: overlapping windowed segments
+// of fftSize samples (the last one ending at the newest sample) are
+// transformed and their power averaged, which trades frequency resolution for
+// a far less noisy estimate than a single periodogram. Output is one-sided in
+// V^2/Hz (dB re 1 V^2/Hz when logScale) in job.freqBins/job.magnitude.
+//
+// Segments are independent, so with job.parallel they are split across the
+// worker pool. Every slot taking part has its own aligned buffers and power
+// sums (reused between calls; a run that stays on one thread touches one), and the pffft setup and window table are read-only while
+// they run.
+constexpr size_t kMaxWelchSegments = 4096;   // Newest segments kept for very long buffers
+constexpr size_t kWelchSegmentsPerChunk = 8; // Parallel grain
+
+inline size_t WelchHop(int fftSize, float overlap) {
+  overlap = std::min(std::max(overlap, 0.0f), 0.95f);
+  return std::max<size_t>(1, (size_t)std::lround(fftSize * (1.0 - overlap)));
+}
+
+// Samples the newest kMaxWelchSegments segments span: anything older is
+// never averaged, so callers need not copy it into the job
+inline size_t WelchMaxSamples(int fftSize, float overlap) {
+  return (kMaxWelchSegments - 1) * WelchHop(fftSize, overlap) + (size_t)fftSize;
+}
+
+inline void ComputeWelchPSD(FFTJob& job, FFTScratch& scratch) {
+  int fftSize = job.fftSize;
+  double fs = job.fs;
+  const double* values = job.values.data();
+  size_t count = job.values.size();
+  job.welchSegments = 0;
+  PFFFT_Setup* setup = nullptr;
+  if (count < (size_t)fftSize || fftSize < 32 || (fftSize & (fftSize - 1)) != 0 || fs <= 0.0 ||
+      !(setup = GetCachedPFFTSetup(fftSize))) {
+    job.freqBins.clear();
+    job.magnitude.clear();
+    return;
+  }
+
+  const WindowTable& window = *GetWindowTable(job.window, fftSize);
+  size_t hop = WelchHop(fftSize, job.overlap);
+  size_t segments = std::min((count - fftSize) / hop + 1, kMaxWelchSegments);
+  size_t firstStart = count - fftSize - (segments - 1) * hop;
+  int numFreqBins = fftSize / 2;
+
+  WorkerPool& pool = GetWorkerPool();
+  size_t slots = job.parallel ? pool.SlotsFor(segments, kWelchSegmentsPerChunk) : 1;
+  if (scratch.slotWorkspaces.size() < slots) scratch.slotWorkspaces.resize(slots);
+  if (scratch.slotPower.size() < slots) scratch.slotPower.resize(slots);
+  for (size_t s = 0; s < slots; s++) {
+    if (!scratch.slotWorkspaces[s].Prepare(fftSize)) {
+      job.freqBins.clear();
+      job.magnitude.clear();
+      return;
+    }
+    scratch.slotPower[s].assign(numFreqBins, 0.0);
+  }
+
+  auto transformSegments = [&](size_t begin, size_t end, size_t slot) {
+    FFTWorkspace& ws = scratch.slotWorkspaces[slot];
+    double* power = scratch.slotPower[slot].data();
+    float* input = ws.input.Data();
+    const float* output = ws.output.Data();
+    for (size_t seg = begin; seg < end; seg++) {
+      const double* x = values + firstStart + seg * hop;
+      for (int i = 0; i < fftSize; i++) input[i] = static_cast<float>(x[i]);
+      MultiplyFloats(input, window.coeffs.data(), fftSize);
+      pffft_transform_ordered(setup, input, ws.output.Data(), ws.work.Data(), PFFFT_FORWARD);
+      power[0] += (double)output[0] * output[0];
+      for (int k = 1; k < numFreqBins; k++) {
+        double re = output[2 * k];
+        double im = output[2 * k + 1];
+        power[k] += re * re + im * im;
+      }
+    }
+  };
+  if (slots > 1) {
+    pool.ParallelFor(segments, kWelchSegmentsPerChunk, transformSegments);
+  } else {
+    transformSegments(0, segments, 0);
+  }
+
+  // Average, scale to a one-sided density: 2 |X|^2 / (fs * sum(w^2))
+  job.freqBins.resize(numFreqBins);
+  job.magnitude.resize(numFreqBins);
+  double scale = 1.0 / (fs * window.sumSquares * (double)segments);
+  for (int k = 0; k < numFreqBins; k++) {
+    double sum = 0.0;
+    for (size_t s = 0; s < slots; s++) sum += scratch.slotPower[s][k];
+    double psd = sum * scale * (k == 0 ? 1.0 : 2.0);
+    job.freqBins[k] = k * fs / fftSize;
+    job.magnitude[k] = job.logScale ? 10.0 * log10(psd + 1e-20) : psd;
+  }
+  job.welchSegments = (int)segments;
+}
+
+// Analysis thread entry point of an FFT window job
+inline void RunFFTJob(FFTJob& job, FFTScratch& scratch) {
+  if (job.welch) {
+    ComputeWelchPSD(job, scratch);
+  } else {
+    job.welchSegments = 0;
+    ComputeFFTSpectrum(job, scratch.workspace);
+  }
+}
+
 // -------------------------------------------------------------------------
 // COLORMAP FUNCTIONS (matplotlib-inspired)
 // -------------------------------------------------------------------------
@@ -344,128 +396,296 @@ inline ImU32 GetColormapColor(Colormap colormap, double t) {
   }
 }
 
-// Compute spectrogram from signal data using Short-Time Fourier Transform (STFT)
-// Returns time bins, frequency bins, and 2D magnitude matrix (row-major: [time][freq])
-// Optimized to use pre-allocated buffers from SpectrogramWindow
-inline void ComputeSpectrogram(const std::vector<double>& signalData,
-                       const std::vector<double>& timePoints,
-                       SpectrogramWindow& sw) {
-
-  int fftSize = sw.fftSize;
-  int hopSize = sw.hopSize;
-  bool useHanning = sw.useHanning;
-  bool logScale = sw.logScale;
-  double timeWindowDuration = sw.timeWindow;
-  int maxFrequency = sw.maxFrequency;
-  std::vector<double>& timeBins = sw.cachedTimeBins;
-  std::vector<double>& freqBins = sw.cachedFreqBins;
-  std::vector<double>& magnitudeMatrix = sw.cachedMagnitudeMatrix;
-
-  if (signalData.size() < (size_t)fftSize) {
-    timeBins.clear();
-    freqBins.clear();
-    magnitudeMatrix.clear();
-    return;
+// Magnitude spectrum of values[0, fftSize) into `out` (numBins values,
+// normalized, optionally in dB), highest bin first to match the heatmap
+// layout of SpectrogramColumns. Touches only `ws` and `out`, so columns can
+// be computed on several threads at once.
+inline void ComputeSpectrogramColumn(const double* values, int fftSize, bool logScale,
+                                     PFFFT_Setup* setup, const WindowTable& window,
+                                     FFTWorkspace& ws, double* out, int numBins) {
+  float* input = ws.input.Data();
+  for (int i = 0; i < fftSize; i++) input[i] = static_cast<float>(values[i]);
+
+  if (window.type != WindowType::Rectangular) {
+    MultiplyFloats(input, window.coeffs.data(), fftSize);
   }
 
-  // Calculate sampling frequency
-  double fs = CalculateSamplingFrequency(timePoints, 0, std::min(fftSize, (int)timePoints.size()));
-
-  // Determine how many samples to analyze based on time window
-  int dataStartIdx = 0;
-  int numSamplesToAnalyze = signalData.size();
+  ComputeRealFFT_Direct(setup, input, ws.output.Data(), ws.work.Data(), ws.magnitudes);
 
-  if (timeWindowDuration > 0.0 && !timePoints.empty()) {
-    double endTime = timePoints.back();
-    double startTime = endTime - timeWindowDuration;
-    for (size_t i = 0; i < timePoints.size(); i++) {
-      if (timePoints[i] >= startTime) {
-        dataStartIdx = i;
-        break;
-      }
+  for (int i = 0; i < numBins; i++) {
+    double mag = static_cast<double>(ws.magnitudes[i]) * window.amplitudeCorrection / fftSize;
+    if (logScale) {
+      mag = 20.0 * log10(mag + 1e-10);
     }
-    numSamplesToAnalyze = timePoints.size() - dataStartIdx;
+    out[numBins - 1 - i] = mag;
   }
+}
 
-  // Calculate number of FFT windows
-  int numWindows = 0;
-  if (numSamplesToAnalyze >= fftSize) {
-    numWindows = (numSamplesToAnalyze - fftSize) / hopSize + 1;
-  }
+constexpr size_t kSpectrogramColumnsPerChunk = 4; // Parallel grain
+
+// Streaming Short-Time Fourier Transform over logical samples [0, count) of
+// sig, limited to the last sw.timeWindow seconds. Columns sit on a fixed hop
+// grid in absolute sample indices (see SpectrogramColumns), so only hops that
+// became available since the last update are transformed and columns that
+// left the time window are dropped; a settings or signal change starts over.
+//
+// An update is four steps:
+//   - PlanSpectrogram (UI thread): the column range to show and the columns
+//     missing from the ring, from a few binary searches
+//   - GatherSpectrogramInputs (UI thread, only if columns are missing): the
+//     missing columns' times and a copy of the samples they read
+//   - RunSpectrogramJob (analysis thread): transform the missing columns
+//   - ApplySpectrogramJob (UI thread, when collected): trim the ring to the
+//     planned range and insert the new columns
+// The ring only changes in the last step, so the window keeps drawing the
+// previous columns while a job runs.
+//
+// fs is the signal's sampling rate (Signal::Rate()). PlanSpectrogram returns
+// false if the ring already matches; the job needs the gather and
+// RunSpectrogramJob only if job.pending isn't empty, otherwise it is a trim
+// to apply directly.
+inline bool PlanSpectrogram(const Signal& sig, size_t count, double fs,
+                            const SpectrogramWindow& sw, SpectrogramJob& job) {
+  int fftSize = sw.fftSize;
+  int hopSize = std::max(sw.hopSize, 1);
+  const SpectrogramColumns& columns = sw.columns;
+
+  job.signal = &sig;
+  job.generation = sig.generation;
+  job.fftSize = fftSize;
+  job.hopSize = hopSize;
+  job.window = sw.window;
+  job.logScale = sw.logScale;
+  job.maxFrequency = sw.maxFrequency;
+  job.parallel = sw.parallel;
+  job.fs = fs;
+  job.bins = 0;
+  job.reset = false;
+  job.firstCol = job.endCol = 0;
+  job.pending.clear();
+  job.values.clear();
+  job.failed = false;
 
-  if (numWindows <= 0) {
-    timeBins.clear();
-    freqBins.clear();
-    magnitudeMatrix.clear();
-    return;
+  // pffft requires N >= 32 and power of 2
+  count = std::min(count, sig.Size());
+  if (count < (size_t)fftSize || fftSize < 32 || (fftSize & (fftSize - 1)) != 0) {
+    return !columns.Empty();
   }
 
   int numFreqBins = fftSize / 2;
   double freqResolution = fs / fftSize;
   int actualNumFreqBins = numFreqBins;
-  if (maxFrequency > 0 && maxFrequency < fs / 2.0) {
-    actualNumFreqBins = std::min(numFreqBins, (int)(maxFrequency / freqResolution));
+  if (sw.maxFrequency > 0 && sw.maxFrequency < fs / 2.0) {
+    actualNumFreqBins = std::min(numFreqBins, (int)(sw.maxFrequency / freqResolution));
   }
   if (actualNumFreqBins <= 0) actualNumFreqBins = 1;
+  job.bins = actualNumFreqBins;
+
+  job.reset = sw.cachedSignal != &sig || sw.cachedGeneration != sig.generation ||
+              sw.cachedFftSize != fftSize || sw.cachedHopSize != hopSize ||
+              sw.cachedWindow != sw.window || sw.cachedLogScale != sw.logScale ||
+              sw.cachedMaxFrequency != sw.maxFrequency || columns.Bins() != actualNumFreqBins;
+
+  // Absolute sample range to cover: the time window ending at the last sample
+  int64_t base = (int64_t)(sig.totalCount - sig.Size());
+  int64_t endAbs = base + (int64_t)count;
+  int64_t startAbs = base;
+  if (sw.timeWindow > 0.0 && sig.IsMonotonic()) {
+    double startTime = sig.XAt(count - 1) - sw.timeWindow;
+    startAbs = base + (int64_t)std::min(sig.LowerBound(startTime), count);
+  }
 
-  timeBins.resize(numWindows);
-  freqBins.resize(actualNumFreqBins);
-  magnitudeMatrix.resize(numWindows * actualNumFreqBins);
+  // Hop-grid columns whose samples all lie in [startAbs, endAbs)
+  int64_t firstCol = (startAbs + hopSize - 1) / hopSize;
+  int64_t endCol = (endAbs - fftSize) / hopSize + 1;
+  if (endCol <= firstCol) {
+    return job.reset || !columns.Empty();
+  }
+  job.firstCol = firstCol;
+  job.endCol = endCol;
+
+  // Whatever part of the old range is still wanted stays in the ring
+  bool keep = !job.reset && !columns.Empty() && endCol > columns.FirstIndex() && firstCol < columns.EndIndex();
+  int64_t keptFirst = keep ? std::max(columns.FirstIndex(), firstCol) : endCol;
+  int64_t backFrom = keep ? std::min(columns.EndIndex(), endCol) : firstCol;
+
+  // Missing columns: older ones newest first (pushed at the front), then
+  // the newer ones in order (pushed at the back)
+  for (int64_t col = keptFirst - 1; keep && col >= firstCol; col--) {
+    job.pending.emplace_back(col, 0.0);
+  }
+  for (int64_t col = backFrom; col < endCol; col++) {
+    job.pending.emplace_back(col, 0.0);
+  }
 
-  for (int i = 0; i < actualNumFreqBins; i++) {
-    freqBins[i] = i * freqResolution;
+  return job.reset || !job.pending.empty() ||
+         (!columns.Empty() && (columns.FirstIndex() != firstCol || columns.EndIndex() != endCol));
+}
+
+// UI thread, same frame as PlanSpectrogram: the time of each missing column
+// and the samples they read, copied as one contiguous run (analysis threads
+// never touch the signal's storage)
+inline void GatherSpectrogramInputs(const Signal& sig, SpectrogramJob& job) {
+  int64_t base = (int64_t)(sig.totalCount - sig.Size());
+  int64_t lo = INT64_MAX, hi = 0;
+  for (auto& p : job.pending) {
+    int64_t start = p.first * job.hopSize;
+    p.second = sig.XAt((size_t)(start - base + job.fftSize / 2));
+    lo = std::min(lo, start);
+    hi = std::max(hi, start + job.fftSize);
   }
+  if (job.pending.empty()) return;
+  job.valuesBegin = lo;
+  job.values.reserve((size_t)(hi - lo));
+  sig.ForEachSpan((size_t)(lo - base), (size_t)(hi - lo), [&](const double*, const double* y, size_t n) {
+    job.values.insert(job.values.end(), y, y + n);
+  });
+}
+
+// Analysis thread: transform the job's missing columns into job.mags. Hops
+// are independent, so with job.parallel they are split across the worker
+// pool, each slot with its own aligned buffers, each column written to its
+// own part of job.mags.
+inline void RunSpectrogramJob(SpectrogramJob& job, SpectrogramScratch& scratch) {
+  int fftSize = job.fftSize;
+  int numBins = job.bins;
+  size_t n = job.pending.size();
+  job.mags.resize(n * (size_t)numBins);
 
   PFFFT_Setup* setup = GetCachedPFFTSetup(fftSize);
-  if (!setup) return;
-
-  // Manage pffft aligned buffers (resize if needed)
-  if (!sw.pffft_work || sw.pffft_buffer_size != fftSize) {
-    if (sw.pffft_work) pffft_aligned_free(sw.pffft_work);
-    if (sw.pffft_output) pffft_aligned_free(sw.pffft_output);
-    if (sw.pffft_input) pffft_aligned_free(sw.pffft_input);
-    
-    sw.pffft_work = (float*)pffft_aligned_malloc(fftSize * sizeof(float));
-    sw.pffft_output = (float*)pffft_aligned_malloc(fftSize * sizeof(float));
-    sw.pffft_input = (float*)pffft_aligned_malloc(fftSize * sizeof(float));
-    sw.pffft_buffer_size = fftSize;
-  }
-  
-  sw.magnitudesFloat.resize(numFreqBins);
-
-  for (int windowIdx = 0; windowIdx < numWindows; windowIdx++) {
-    int startIdx = dataStartIdx + windowIdx * hopSize;
-
-    int centerIdx = startIdx + fftSize / 2;
-    if (centerIdx < (int)timePoints.size()) {
-      timeBins[windowIdx] = timePoints[centerIdx];
-    } else {
-      timeBins[windowIdx] = timePoints.back();
-    }
+  if (!setup) {
+    job.failed = true;
+    return;
+  }
 
-    for (int i = 0; i < fftSize; i++) {
-        if (startIdx + i < (int)signalData.size()) {
-            sw.pffft_input[i] = static_cast<float>(signalData[startIdx + i]);
-        } else {
-            sw.pffft_input[i] = 0.0f;
-        }
+  const WindowTable& window = *GetWindowTable(job.window, fftSize);
+  WorkerPool& pool = GetWorkerPool();
+  size_t slots = job.parallel ? pool.SlotsFor(n, kSpectrogramColumnsPerChunk) : 1;
+  if (scratch.slotWorkspaces.size() < slots) scratch.slotWorkspaces.resize(slots);
+  for (size_t s = 0; s < slots; s++) {
+    if (!scratch.slotWorkspaces[s].Prepare(fftSize)) {
+      job.failed = true;
+      return;
     }
-
-    if (useHanning) {
-        for (int i = 0; i < fftSize; i++) {
-            float window = 0.5f * (1.0f - cosf(2.0f * M_PI * i / (fftSize - 1)));
-            sw.pffft_input[i] *= window;
-        }
+  }
+  auto computeColumns = [&](size_t begin, size_t end, size_t slot) {
+    FFTWorkspace& ws = scratch.slotWorkspaces[slot];
+    for (size_t i = begin; i < end; i++) {
+      const double* x = job.values.data() + (job.pending[i].first * job.hopSize - job.valuesBegin);
+      ComputeSpectrogramColumn(x, fftSize, job.logScale, setup, window, ws, &job.mags[i * numBins], numBins);
     }
+  };
+  if (slots > 1) {
+    pool.ParallelFor(n, kSpectrogramColumnsPerChunk, computeColumns);
+  } else {
+    computeColumns(0, n, 0);
+  }
+}
+
+// UI thread: bring the column ring to the state the job planned. Returns
+// true if the columns changed.
+inline bool ApplySpectrogramJob(const SpectrogramJob& job, SpectrogramWindow& sw) {
+  SpectrogramColumns& columns = sw.columns;
+  if (job.bins == 0 || job.failed) {
+    bool changed = !columns.Empty();
+    columns.Clear();
+    return changed;
+  }
 
-    ComputeRealFFT_Direct(setup, sw.pffft_input, sw.pffft_output, sw.pffft_work, sw.magnitudesFloat);
+  bool changed = false;
+  if (job.reset) {
+    columns.Reset(job.bins);
+    sw.cachedSignal = job.signal;
+    sw.cachedGeneration = job.generation;
+    sw.cachedFftSize = job.fftSize;
+    sw.cachedHopSize = job.hopSize;
+    sw.cachedWindow = job.window;
+    sw.cachedLogScale = job.logScale;
+    sw.cachedMaxFrequency = job.maxFrequency;
+    changed = true;
+  }
 
-    for (int i = 0; i < actualNumFreqBins; i++) {
-      double mag = static_cast<double>(sw.magnitudesFloat[i]) / fftSize;
-      if (logScale) {
-        mag = 20.0 * log10(mag + 1e-10);
-      }
-      magnitudeMatrix[windowIdx * actualNumFreqBins + i] = mag;
+  sw.cachedFs = job.fs;
+  double freqResolution = job.fs / job.fftSize;
+  sw.cachedFreqBins.resize(job.bins);
+  for (int i = 0; i < job.bins; i++) {
+    sw.cachedFreqBins[i] = i * freqResolution;
+  }
+
+  // Keep whatever part of the old range is still wanted
+  if (columns.Empty() || job.endCol <= columns.FirstIndex() || job.firstCol >= columns.EndIndex()) {
+    changed |= !columns.Empty();
+    columns.Clear();
+  } else {
+    if (columns.FirstIndex() < job.firstCol) {
+      columns.PopFront((size_t)(job.firstCol - columns.FirstIndex()));
+      changed = true;
     }
+    if (columns.EndIndex() > job.endCol) {
+      columns.PopBack((size_t)(columns.EndIndex() - job.endCol));
+      changed = true;
+    }
+  }
+  if (job.pending.empty()) return changed;
+
+  columns.Reserve(columns.Count() + job.pending.size());
+  for (size_t i = 0; i < job.pending.size(); i++) {
+    int64_t col = job.pending[i].first;
+    double* out = !columns.Empty() && col < columns.FirstIndex()
+                      ? columns.PushFront(job.pending[i].second)
+                      : columns.PushBack(col, job.pending[i].second);
+    std::copy_n(&job.mags[i * job.bins], job.bins, out);
   }
+  return true;
+}
+
+// Color scale limits for the current columns (sw.magMin/magMax). Run after
+// the columns or the range settings change, not per frame.
+inline void UpdateSpectrogramRange(SpectrogramWindow& sw) {
+  const SpectrogramColumns& columns = sw.columns;
+  if (sw.rangeMode == SpectrogramRange::Fixed) {
+    sw.magMin = sw.fixedMin;
+    sw.magMax = std::max(sw.fixedMax, sw.fixedMin + 1e-6f);
+    return;
+  }
+  if (columns.Empty()) return;
+
+  if (sw.rangeMode == SpectrogramRange::Auto) {
+    double lo = std::numeric_limits<double>::infinity();
+    double hi = -lo;
+    columns.ForEachRun([&](const double* mags, size_t, size_t n) {
+      const double* end = mags + n * columns.Bins();
+      for (const double* m = mags; m != end; m++) {
+        lo = std::min(lo, *m);
+        hi = std::max(hi, *m);
+      }
+    });
+    sw.magMin = lo;
+    sw.magMax = hi;
+    return;
+  }
+
+  // Percentiles over an evenly strided sample of at most kMaxSamples cells
+  constexpr size_t kMaxSamples = 65536;
+  size_t cells = columns.Count() * columns.Bins();
+  size_t stride = (cells + kMaxSamples - 1) / kMaxSamples;
+  std::vector<double>& values = sw.rangeScratch;
+  values.clear();
+  size_t cell = 0;
+  columns.ForEachRun([&](const double* mags, size_t, size_t n) {
+    size_t runCells = n * columns.Bins();
+    for (size_t i = (stride - cell % stride) % stride; i < runCells; i += stride) values.push_back(mags[i]);
+    cell += runCells;
+  });
+  if (values.empty()) return;
+
+  auto percentile = [&](float p) {
+    size_t k = (size_t)std::lround(std::clamp(p, 0.0f, 100.0f) / 100.0 * (values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+  };
+  float low = std::min(sw.percentileLow, sw.percentileHigh);
+  float high = std::max(sw.percentileLow, sw.percentileHigh);
+  sw.magMin = percentile(low);
+  sw.magMax = percentile(high);
 }
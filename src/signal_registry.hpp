@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "types.hpp"
+
+// -------------------------------------------------------------------------
+// SIGNAL REGISTRY
+// -------------------------------------------------------------------------
+// Every signal gets a dense integer handle on first registration:
+//
+//   - Handle table: signals live in fixed blocks of heap slots, so a handle
+//     (and the Signal* behind it) stays valid for the life of the registry.
+//     Clearing data (ClearAll, Lua clear_all_signals) keeps the handles.
+//   - Name index: hash maps keyed by a string_view of the signal's own name
+//     (interned in the Signal, no second copy), split into shards with their
+//     own lock so several ingest threads can register in parallel.
+//
+// Get(handle), Count() and ForEach() are lock-free. Appending to a signal
+// follows the single-writer rule of Signal (one ingest thread per signal),
+// so threads feeding different signals never contend.
+
+using SignalHandle = uint32_t;
+constexpr SignalHandle kInvalidSignalHandle = 0xFFFFFFFFu;
+
+class SignalRegistry {
+public:
+  static constexpr size_t kShards = 16;
+  static constexpr size_t kBlockSize = 1024;   // Signals per handle block
+  static constexpr size_t kMaxBlocks = 1024;   // Up to ~1M signals
+
+  SignalRegistry() = default;
+  SignalRegistry(const SignalRegistry&) = delete;
+  SignalRegistry& operator=(const SignalRegistry&) = delete;
+  ~SignalRegistry() { Reset(); }
+
+  // Handle for `name`, creating the signal with (maxSize, mode) if needed
+  SignalHandle Register(const std::string& name, int maxSize, PlaybackMode mode, bool* created = nullptr) {
+    Shard& shard = ShardFor(name);
+    {
+      std::shared_lock<std::shared_mutex> lock(shard.mutex);
+      auto it = shard.index.find(name);
+      if (it != shard.index.end()) {
+        if (created) *created = false;
+        return it->second;
+      }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.index.find(name);
+    if (it != shard.index.end()) {
+      if (created) *created = false;
+      return it->second;
+    }
+    auto sig = std::make_unique<Signal>(name, maxSize, mode);
+    std::string_view key = sig->name; // Interned: the Signal never moves
+    SignalHandle handle = Append(std::move(sig));
+    if (handle == kInvalidSignalHandle) {
+      if (created) *created = false;
+      return handle;
+    }
+    shard.index.emplace(key, handle);
+    if (created) *created = true;
+    return handle;
+  }
+
+  // Handle for `name`, or kInvalidSignalHandle
+  SignalHandle FindHandle(std::string_view name) const {
+    const Shard& shard = ShardFor(name);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.index.find(name);
+    return it != shard.index.end() ? it->second : kInvalidSignalHandle;
+  }
+
+  Signal* Find(std::string_view name) const { return Get(FindHandle(name)); }
+  bool Contains(std::string_view name) const { return FindHandle(name) != kInvalidSignalHandle; }
+
+  // Signal behind a handle (nullptr if the handle was never issued)
+  Signal* Get(SignalHandle handle) const {
+    if (handle >= count.load(std::memory_order_acquire)) return nullptr;
+    Block* block = blocks[handle / kBlockSize].load(std::memory_order_acquire);
+    return block->slots[handle % kBlockSize].get();
+  }
+
+  size_t Count() const { return count.load(std::memory_order_acquire); }
+  bool Empty() const { return Count() == 0; }
+
+  // fn(Signal&) for every signal, in registration (handle) order
+  template <typename Fn>
+  void ForEach(Fn&& fn) const {
+    size_t n = Count();
+    for (size_t b = 0; b * kBlockSize < n; b++) {
+      Block* block = blocks[b].load(std::memory_order_acquire);
+      size_t end = std::min(kBlockSize, n - b * kBlockSize);
+      for (size_t i = 0; i < end; i++) fn(*block->slots[i]);
+    }
+  }
+
+  // fn(Signal&) in name order (signal browser, profiler). The sorted handle
+  // list is rebuilt only when signals were added.
+  template <typename Fn>
+  void ForEachSorted(Fn&& fn) const {
+    std::lock_guard<std::mutex> lock(sortedMutex);
+    size_t n = Count();
+    if (sorted.size() != n) {
+      sorted.resize(n);
+      for (size_t i = 0; i < n; i++) sorted[i] = (SignalHandle)i;
+      std::sort(sorted.begin(), sorted.end(),
+                [this](SignalHandle a, SignalHandle b) { return Get(a)->name < Get(b)->name; });
+    }
+    for (SignalHandle h : sorted) fn(*Get(h));
+  }
+
+  // Drop every signal's samples; names and handles stay valid
+  void ClearAll() {
+    ForEach([](Signal& sig) { sig.Clear(); });
+  }
+
+  // Destroy all signals (shutdown only: invalidates every handle)
+  void Reset() {
+    // Same lock order as Register: shard, then table
+    std::unique_lock<std::shared_mutex> shardLocks[kShards];
+    for (size_t i = 0; i < kShards; i++) {
+      shardLocks[i] = std::unique_lock<std::shared_mutex>(shards[i].mutex);
+      shards[i].index.clear();
+    }
+    std::lock_guard<std::mutex> tableLock(tableMutex);
+    count.store(0, std::memory_order_release);
+    for (auto& slot : blocks) {
+      delete slot.exchange(nullptr);
+    }
+    std::lock_guard<std::mutex> lock(sortedMutex);
+    sorted.clear();
+  }
+
+private:
+  struct Block {
+    std::unique_ptr<Signal> slots[kBlockSize];
+  };
+
+  struct Shard {
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string_view, SignalHandle> index;
+  };
+
+  Shard& ShardFor(std::string_view name) { return shards[std::hash<std::string_view>()(name) % kShards]; }
+  const Shard& ShardFor(std::string_view name) const {
+    return shards[std::hash<std::string_view>()(name) % kShards];
+  }
+
+  // Store a new signal in the next slot and publish it
+  SignalHandle Append(std::unique_ptr<Signal> sig) {
+    std::lock_guard<std::mutex> lock(tableMutex);
+    size_t handle = count.load(std::memory_order_relaxed);
+    size_t b = handle / kBlockSize;
+    if (b >= kMaxBlocks) {
+      printf("[SignalRegistry] Limit of %zu signals reached, '%s' not registered\n",
+             kBlockSize * kMaxBlocks, sig->name.c_str());
+      return kInvalidSignalHandle;
+    }
+    Block* block = blocks[b].load(std::memory_order_relaxed);
+    if (!block) {
+      block = new Block();
+      blocks[b].store(block, std::memory_order_release);
+    }
+    block->slots[handle % kBlockSize] = std::move(sig);
+    count.store(handle + 1, std::memory_order_release);
+    return (SignalHandle)handle;
+  }
+
+  Shard shards[kShards];
+  std::atomic<Block*> blocks[kMaxBlocks] = {};
+  std::atomic<size_t> count{0};
+  std::mutex tableMutex;
+
+  mutable std::mutex sortedMutex;
+  mutable std::vector<SignalHandle> sorted;
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <utility>
+
+// -------------------------------------------------------------------------
+// INCREMENTAL SIGNAL STATISTICS
+// -------------------------------------------------------------------------
+// Count, min, max, mean, variance (Welford) and last value, updated in O(1)
+// per sample so readouts, histograms and Lua queries never rescan a buffer.
+//
+//   - RunningStats: every sample since the signal was last cleared
+//   - Windowed stats (online rings): Remove() undoes the evicted sample and
+//     WindowedExtrema tracks min/max with monotonic queues
+//   - SampleRateEstimate: exponentially smoothed sample interval and jitter,
+//     so DSP code and readouts get the sampling rate without a timestamp scan
+
+struct RunningStats {
+  uint64_t count = 0;
+  double min = 0.0;
+  double max = 0.0;
+  double mean = 0.0;
+  double m2 = 0.0;   // Sum of squared deviations from the mean
+  double last = 0.0;
+
+  void Add(double v) {
+    count++;
+    if (count == 1) {
+      min = max = mean = v;
+      m2 = 0.0;
+    } else {
+      min = std::min(min, v);
+      max = std::max(max, v);
+      double delta = v - mean;
+      mean += delta / (double)count;
+      m2 += delta * (v - mean);
+    }
+    last = v;
+  }
+
+  // Undo Add(v) for mean/variance (min/max are tracked by the caller)
+  void Remove(double v) {
+    if (count <= 1) {
+      count = 0;
+      mean = m2 = 0.0;
+      return;
+    }
+    double delta = v - mean;
+    count--;
+    mean -= delta / (double)count;
+    m2 = std::max(0.0, m2 - delta * (v - mean));
+  }
+
+  void Reset() { *this = RunningStats(); }
+
+  // Population variance
+  double Variance() const { return count > 0 ? m2 / (double)count : 0.0; }
+  double StdDev() const { return std::sqrt(Variance()); }
+  double Rms() const { return std::sqrt(mean * mean + Variance()); }
+};
+
+// Sliding-window min/max over absolute sample indices (amortized O(1))
+class WindowedExtrema {
+public:
+  void Push(uint64_t index, double v) {
+    while (!minQueue.empty() && minQueue.back().second >= v) minQueue.pop_back();
+    minQueue.emplace_back(index, v);
+    while (!maxQueue.empty() && maxQueue.back().second <= v) maxQueue.pop_back();
+    maxQueue.emplace_back(index, v);
+  }
+
+  // Drop samples with index < oldest
+  void Evict(uint64_t oldest) {
+    while (!minQueue.empty() && minQueue.front().first < oldest) minQueue.pop_front();
+    while (!maxQueue.empty() && maxQueue.front().first < oldest) maxQueue.pop_front();
+  }
+
+  void Clear() {
+    minQueue.clear();
+    maxQueue.clear();
+  }
+
+  bool Empty() const { return minQueue.empty(); }
+  double Min() const { return minQueue.empty() ? 0.0 : minQueue.front().second; }
+  double Max() const { return maxQueue.empty() ? 0.0 : maxQueue.front().second; }
+
+private:
+  std::deque<std::pair<uint64_t, double>> minQueue;
+  std::deque<std::pair<uint64_t, double>> maxQueue;
+};
+
+// Exponentially weighted sample interval (dt) and its jitter
+struct SampleRateEstimate {
+  static constexpr double kAlpha = 1.0 / 32.0; // Smoothing weight of the newest interval
+  static constexpr double kMaxGapFactor = 8.0; // Intervals beyond 8x dt count as 8x dt
+
+  uint64_t intervals = 0; // Positive intervals seen
+  double dt = 0.0;        // Smoothed interval (s)
+  double variance = 0.0;  // Smoothed squared deviation from dt
+  double lastGap = 0.0;   // Most recent interval, as received
+  double maxGap = 0.0;    // Largest interval since the last reset
+
+  void Add(double gap) {
+    lastGap = gap;
+    if (gap <= 0.0) return; // Duplicate or out-of-order timestamp
+    maxGap = std::max(maxGap, gap);
+    if (intervals++ == 0) {
+      dt = gap;
+      variance = 0.0;
+      return;
+    }
+    // A stall is reported through lastGap/maxGap; clamp it here so one
+    // outage doesn't drag the rate estimate for the next hundred samples
+    double delta = std::min(gap, kMaxGapFactor * dt) - dt;
+    dt += kAlpha * delta;
+    variance = (1.0 - kAlpha) * (variance + kAlpha * delta * delta);
+  }
+
+  void Reset() { *this = SampleRateEstimate(); }
+
+  bool Valid() const { return intervals > 0 && dt > 0.0; }
+  double Frequency(double fallback = 0.0) const { return Valid() ? 1.0 / dt : fallback; }
+  double Jitter() const { return std::sqrt(variance); }
+
+  // Jitter within `tolerance` of dt (e.g. 0.1 = 10%)
+  bool IsRegular(double tolerance = 0.1) const { return Valid() && Jitter() <= tolerance * dt; }
+};
+
+// Published state read by lock-free consumers (see Signal::Stats/Rate)
+struct SignalStats {
+  RunningStats total;       // Since the last Clear
+  RunningStats window;      // Samples currently held (ring contents online, everything offline)
+  SampleRateEstimate rate;  // Sampling interval since the last Clear
+};
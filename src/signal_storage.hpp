@@ -0,0 +1,621 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "mapped_file.hpp"
+#include "signal_compression.hpp"
+#include "signal_sync.hpp"
+
+// -------------------------------------------------------------------------
+// CHUNKED SIGNAL STORAGE (OFFLINE MODE)
+// -------------------------------------------------------------------------
+// Offline signals grow without a fixed bound, so they are stored as a list of
+// fixed-size chunks instead of two ever-growing vectors. Appending never
+// moves existing samples (no reallocation spikes, no 2x peak while a vector
+// copies itself), and released chunks are recycled through a shared pool so
+// reloading a log reuses the memory of the previous one.
+
+// Samples per chunk (64K samples -> 1 MB per chunk for X and Y together)
+constexpr size_t kSignalChunkSamples = 65536;
+
+struct SignalChunk {
+  double x[kSignalChunkSamples]; // Time
+  double y[kSignalChunkSamples]; // Value
+};
+
+// Process-wide free list of chunks
+class SignalChunkPool {
+public:
+  // Maximum number of idle chunks kept around for reuse (64 MB)
+  static constexpr size_t kMaxIdleChunks = 64;
+
+  SignalChunk* Acquire() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!idle.empty()) {
+        SignalChunk* chunk = idle.back();
+        idle.pop_back();
+        return chunk;
+      }
+    }
+    return new SignalChunk;
+  }
+
+  void Release(SignalChunk* chunk) {
+    if (!chunk) return;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (idle.size() < kMaxIdleChunks) {
+        idle.push_back(chunk);
+        return;
+      }
+    }
+    delete chunk;
+  }
+
+  // Return a chunk straight to the allocator (memory pressure)
+  void Free(SignalChunk* chunk) { delete chunk; }
+
+  // Drop idle chunks beyond `keep`
+  void Trim(size_t keep) {
+    std::vector<SignalChunk*> excess;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      while (idle.size() > keep) {
+        excess.push_back(idle.back());
+        idle.pop_back();
+      }
+    }
+    for (SignalChunk* chunk : excess) delete chunk;
+  }
+
+  size_t IdleChunks() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return idle.size();
+  }
+
+  ~SignalChunkPool() {
+    for (SignalChunk* chunk : idle) delete chunk;
+  }
+
+private:
+  std::mutex mutex;
+  std::vector<SignalChunk*> idle;
+};
+
+inline SignalChunkPool& GetSignalChunkPool() {
+  static SignalChunkPool pool;
+  return pool;
+}
+
+// -------------------------------------------------------------------------
+// OUT-OF-CORE OFFLINE STORAGE
+// -------------------------------------------------------------------------
+// For logs larger than RAM, offline chunks can be allocated straight inside
+// memory-mapped segment files in a cache directory instead of on the heap.
+// Readers see ordinary chunk pointers into the mapping; the OS page cache
+// decides which parts stay resident.
+//
+// All series share the segment files: chunks are handed out in allocation
+// order from the current segment, and segments start small and double up
+// to kMappedSegmentChunks, so a log with hundreds of short signals doesn't
+// reserve a whole segment per signal. A segment file is deleted once no
+// series holds a chunk in it (or the process exits).
+
+// Chunks per segment file: the first one (4 MB) and the cap (64 MB)
+constexpr size_t kFirstSegmentChunks = 4;
+constexpr size_t kMappedSegmentChunks = 64;
+
+// Backend used for offline chunks allocated from now on
+class OfflineStorage {
+public:
+  // Empty directory = heap chunks
+  void SetMapped(const std::string& dir) {
+    std::string path = dir;
+    if (!path.empty() && path.back() != '/' && path.back() != '\\') path += '/';
+    std::lock_guard<std::mutex> lock(mutex);
+    directory = path;
+    segment.reset(); // Start the next load with a small segment again
+    segmentChunks = 0;
+  }
+
+  void SetMemory() { SetMapped(""); }
+
+  std::string Directory() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return directory;
+  }
+
+  // Next free chunk in the shared segment for `dir`, opening a new (larger)
+  // segment when it is full. `file` receives the segment, which the caller
+  // keeps open while it uses the chunk. nullptr if no segment can be created.
+  SignalChunk* AllocateMapped(const std::string& dir, std::shared_ptr<MappedFile>& file) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!segment || segmentDir != dir || segmentUsed == segmentChunks) {
+      if (segment) segment->FlushAsync(); // Full segment: let the OS write it back early
+      size_t chunks = (segment && segmentDir == dir)
+                          ? std::min(segmentChunks * 2, kMappedSegmentChunks)
+                          : kFirstSegmentChunks;
+      auto next = std::make_shared<MappedFile>();
+      std::string path = MappedFile::UniquePath(dir, "signakit_column");
+      if (!next->Open(path, chunks * sizeof(SignalChunk), true, true, true)) {
+        segment.reset();
+        return nullptr;
+      }
+      segment = next;
+      segmentDir = dir;
+      segmentChunks = chunks;
+      segmentUsed = 0;
+    }
+    file = segment;
+    return (SignalChunk*)segment->Data() + segmentUsed++;
+  }
+
+private:
+  std::mutex mutex;
+  std::string directory;
+  std::shared_ptr<MappedFile> segment; // Segment new chunks are carved from
+  std::string segmentDir;
+  size_t segmentChunks = 0;
+  size_t segmentUsed = 0;              // Chunks handed out from `segment`
+};
+
+inline OfflineStorage& GetOfflineStorage() {
+  static OfflineStorage storage;
+  return storage;
+}
+
+// A full chunk encoded with GorillaEncode
+struct CompressedChunk {
+  uint64_t id;                // Unique key for the decoded-chunk cache
+  double firstX;              // Time of the chunk's first sample (searchable without decoding)
+  std::vector<uint64_t> bits;
+
+  size_t MemoryBytes() const { return sizeof(CompressedChunk) + bits.capacity() * sizeof(uint64_t); }
+};
+
+inline uint64_t NextCompressedChunkId() {
+  static std::atomic<uint64_t> nextId{1};
+  return nextId++;
+}
+
+// Small process-wide LRU of decoded compressed chunks, so windowed plots and
+// analysis re-reading the same region don't decode it every frame
+class DecodedChunkCache {
+public:
+  static constexpr size_t kCapacity = 16; // 16 MB of decoded samples
+
+  std::shared_ptr<const SignalChunk> Get(const CompressedChunk& block) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (Entry& entry : entries) {
+        if (entry.id == block.id) {
+          entry.lastUse = ++tick;
+          hits++;
+          return entry.chunk;
+        }
+      }
+      misses++;
+    }
+
+    // Decode outside the lock; a racing reader may decode the same block
+    auto decoded = std::make_shared<SignalChunk>();
+    GorillaDecode(block.bits, kSignalChunkSamples, decoded->x, decoded->y);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (entries.size() >= kCapacity) {
+      auto oldest = std::min_element(entries.begin(), entries.end(),
+                                     [](const Entry& a, const Entry& b) { return a.lastUse < b.lastUse; });
+      entries.erase(oldest);
+    }
+    entries.push_back(Entry{block.id, ++tick, decoded});
+    return decoded;
+  }
+
+  // Drop a block that no longer exists
+  void Forget(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [id](const Entry& e) { return e.id == id; }),
+                  entries.end());
+  }
+
+  size_t MemoryBytes() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size() * sizeof(SignalChunk);
+  }
+
+  size_t Hits() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+  }
+
+  size_t Misses() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+  }
+
+private:
+  struct Entry {
+    uint64_t id;
+    uint64_t lastUse;
+    std::shared_ptr<const SignalChunk> chunk;
+  };
+
+  std::mutex mutex;
+  std::vector<Entry> entries;
+  uint64_t tick = 0;
+  size_t hits = 0;
+  size_t misses = 0;
+};
+
+inline DecodedChunkCache& GetDecodedChunkCache() {
+  static DecodedChunkCache cache;
+  return cache;
+}
+
+// Fixed-capacity table of chunk pointers. Never resized in place: when it
+// fills up the writer publishes a larger copy and retires the old one, so a
+// lock-free reader holding the old table can keep using it.
+//
+// A slot holds either raw samples (heap, spill or segment mapping) or, once the chunk
+// has been compressed, a null raw pointer plus the compressed block.
+struct ChunkDirectory {
+  size_t capacity;
+  std::unique_ptr<std::atomic<SignalChunk*>[]> slots;
+  std::unique_ptr<std::atomic<const CompressedChunk*>[]> compressed;
+
+  explicit ChunkDirectory(size_t cap)
+      : capacity(cap), slots(new std::atomic<SignalChunk*>[cap]),
+        compressed(new std::atomic<const CompressedChunk*>[cap]) {
+    for (size_t i = 0; i < cap; i++) {
+      slots[i].store(nullptr, std::memory_order_relaxed);
+      compressed[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  SignalChunk* Get(size_t idx) const { return slots[idx].load(std::memory_order_acquire); }
+  const CompressedChunk* GetCompressed(size_t idx) const {
+    return compressed[idx].load(std::memory_order_acquire);
+  }
+};
+
+// Where a chunk's samples currently live
+enum class ChunkState : uint8_t {
+  Resident,       // Pooled heap chunk
+  Spilled,        // Temporary memory-mapped file
+  Compressed,     // Gorilla-encoded block
+  Incompressible, // Resident; compression was tried and didn't pay off
+  Mapped          // Allocated inside a segment file (out-of-core backend)
+};
+
+// Append-only X/Y series stored in pooled chunks, or in mapped segment
+// files once SetBacking() has named a cache directory
+//
+// Full chunks can be moved to a cheaper tier without readers noticing:
+//   - spilled to a temporary memory-mapped file (pointer redirected into the
+//     mapping, the OS pages it out under pressure)
+//   - compressed in memory (decoded on demand through DecodedChunkCache)
+//
+// Single writer. Readers on other threads must stay inside an EpochGuard and
+// only touch samples below a published size (see SignalPublication).
+class ChunkedSeries {
+public:
+  ChunkedSeries() = default;
+  ChunkedSeries(const ChunkedSeries&) = delete;
+  ChunkedSeries& operator=(const ChunkedSeries&) = delete;
+
+  ChunkedSeries(ChunkedSeries&& other) noexcept { Steal(other); }
+
+  ChunkedSeries& operator=(ChunkedSeries&& other) noexcept {
+    if (this != &other) {
+      Clear();
+      Steal(other);
+    }
+    return *this;
+  }
+
+  ~ChunkedSeries() { Clear(); }
+
+  void Append(double x, double y) {
+    size_t slot = count % kSignalChunkSamples;
+    if (slot == 0 && count / kSignalChunkSamples == chunkCount) {
+      AddChunk();
+    }
+    SignalChunk* chunk = directory.load(std::memory_order_relaxed)->Get(count / kSignalChunkSamples);
+    chunk->x[slot] = x;
+    chunk->y[slot] = y;
+    count++;
+  }
+
+  size_t Size() const { return count; }
+
+  double X(size_t i) const { return Sample(i, true); }
+  double Y(size_t i) const { return Sample(i, false); }
+
+  // Visit [first, first + n) as contiguous runs: fn(const double* x, const double* y, size_t len)
+  // Readers off the writer thread pass the published size as `limit`; if the
+  // series was cleared underneath them the walk simply stops early.
+  template <typename Fn>
+  void ForEachSpan(size_t first, size_t n, Fn&& fn, size_t limit = SIZE_MAX) const {
+    size_t end = std::min(first + n, limit == SIZE_MAX ? count : limit);
+    const ChunkDirectory* dir = directory.load(std::memory_order_acquire);
+    while (first < end) {
+      size_t chunkIdx = first / kSignalChunkSamples;
+      size_t slot = first % kSignalChunkSamples;
+      size_t len = std::min(kSignalChunkSamples - slot, end - first);
+      if (!dir || chunkIdx >= dir->capacity) return;
+      if (const SignalChunk* chunk = dir->Get(chunkIdx)) {
+        fn(chunk->x + slot, chunk->y + slot, len);
+      } else if (const CompressedChunk* block = dir->GetCompressed(chunkIdx)) {
+        std::shared_ptr<const SignalChunk> decoded = GetDecodedChunkCache().Get(*block);
+        fn(decoded->x + slot, decoded->y + slot, len);
+      } else {
+        return;
+      }
+      first += len;
+    }
+  }
+
+  // Raw pointers to [first, first + n) if they lie in one uncompressed chunk
+  bool Contiguous(size_t first, size_t n, const double*& x, const double*& y) const {
+    if (n == 0 || first + n > count) return false;
+    size_t chunkIdx = first / kSignalChunkSamples;
+    if ((first + n - 1) / kSignalChunkSamples != chunkIdx) return false;
+    const SignalChunk* chunk = directory.load(std::memory_order_acquire)->Get(chunkIdx);
+    if (!chunk) return false;
+    x = chunk->x + first % kSignalChunkSamples;
+    y = chunk->y + first % kSignalChunkSamples;
+    return true;
+  }
+
+  // First index in [lo, hi) where before(X(i)) is false, for times sorted
+  // over that range. Bisects on each chunk's first timestamp (stored beside
+  // compressed blocks) down to one chunk, so at most one chunk is decoded.
+  template <typename Pred>
+  size_t Search(size_t lo, size_t hi, Pred before) const {
+    if (lo >= hi) return lo;
+    const ChunkDirectory* dir = directory.load(std::memory_order_acquire);
+    // Last chunk in [lo's chunk, hi - 1's chunk] whose first sample is still `before`
+    size_t c = lo / kSignalChunkSamples;
+    size_t cHi = (hi - 1) / kSignalChunkSamples;
+    while (c < cHi) {
+      size_t mid = c + (cHi - c + 1) / 2;
+      if (before(FirstX(dir, mid))) c = mid; else cHi = mid - 1;
+    }
+
+    size_t begin = std::max(lo, c * kSignalChunkSamples);
+    size_t end = std::min(hi, (c + 1) * kSignalChunkSamples);
+    const double* x = nullptr;
+    std::shared_ptr<const SignalChunk> decoded;
+    if (const SignalChunk* chunk = dir->Get(c)) {
+      x = chunk->x;
+    } else {
+      decoded = GetDecodedChunkCache().Get(*dir->GetCompressed(c));
+      x = decoded->x;
+    }
+    size_t base = c * kSignalChunkSamples;
+    const double* found = std::partition_point(x + (begin - base), x + (end - base),
+                                               [&](double t) { return before(t); });
+    return base + (size_t)(found - x);
+  }
+
+  // Chunks go back to the pool only after concurrent readers have moved on
+  void Clear() {
+    ChunkDirectory* dir = directory.exchange(nullptr);
+    size_t n = chunkCount;
+    std::vector<ChunkState> oldStates = std::move(states);
+    std::vector<std::shared_ptr<MappedFile>> files = std::move(mappedFiles);
+    chunkCount = 0;
+    count = 0;
+    states.clear();
+    mappedFiles.clear();
+    compressedBytes = 0;
+    if (!dir) return;
+    GetSignalEpochs().Retire([dir, n, oldStates, files]() {
+      for (size_t i = 0; i < n; i++) {
+        if (oldStates[i] == ChunkState::Compressed) {
+          const CompressedChunk* block = dir->GetCompressed(i);
+          GetDecodedChunkCache().Forget(block->id);
+          delete block;
+        } else if (oldStates[i] != ChunkState::Spilled && oldStates[i] != ChunkState::Mapped) {
+          GetSignalChunkPool().Release(dir->Get(i));
+        }
+      }
+      delete dir;
+    });
+  }
+
+  // Move every full, still-resident chunk into one temporary mapped file in
+  // `dir`. Returns the number of heap bytes released (0 on failure).
+  size_t SpillFullChunks(const std::string& dir) {
+    std::vector<size_t> victims;
+    for (size_t i = 0; i + 1 < chunkCount; i++) {
+      if (IsResident(i)) victims.push_back(i);
+    }
+    if (victims.empty()) return 0;
+
+    auto file = std::make_shared<MappedFile>();
+    std::string path = MappedFile::UniquePath(dir, "signakit_spill");
+    if (!file->Open(path, victims.size() * sizeof(SignalChunk), true, true, true)) {
+      return 0;
+    }
+
+    ChunkDirectory* table = directory.load(std::memory_order_relaxed);
+    SignalChunk* mapped = (SignalChunk*)file->Data();
+    std::vector<SignalChunk*> released;
+    for (size_t k = 0; k < victims.size(); k++) {
+      size_t i = victims[k];
+      SignalChunk* heap = table->Get(i);
+      std::memcpy(&mapped[k], heap, sizeof(SignalChunk));
+      table->slots[i].store(&mapped[k], std::memory_order_release);
+      states[i] = ChunkState::Spilled;
+      released.push_back(heap);
+    }
+    file->FlushAsync();
+    mappedFiles.push_back(file);
+
+    // Readers may still be copying from the heap copies
+    GetSignalEpochs().Retire([released]() {
+      for (SignalChunk* chunk : released) GetSignalChunkPool().Free(chunk);
+    });
+    return released.size() * sizeof(SignalChunk);
+  }
+
+  // Compress up to maxChunks full resident chunks, leaving the newest
+  // keepRaw full chunks alone (they are the ones being plotted live). Chunks
+  // that would not shrink below minRatio of their raw size stay as they are.
+  // Returns the number of heap bytes released.
+  size_t CompressFullChunks(size_t maxChunks, size_t keepRaw, double minRatio = 0.75) {
+    ChunkDirectory* table = directory.load(std::memory_order_relaxed);
+    size_t saved = 0;
+    std::vector<SignalChunk*> released;
+    for (size_t i = 0; i + 1 + keepRaw < chunkCount && maxChunks > 0; i++) {
+      if (states[i] != ChunkState::Resident) continue;
+      maxChunks--;
+
+      SignalChunk* raw = table->Get(i);
+      CompressedChunk* block = new CompressedChunk{NextCompressedChunkId(), raw->x[0], {}};
+      GorillaEncode(raw->x, raw->y, kSignalChunkSamples, block->bits);
+      block->bits.shrink_to_fit();
+      if (block->MemoryBytes() > sizeof(SignalChunk) * minRatio) {
+        delete block;
+        states[i] = ChunkState::Incompressible;
+        continue;
+      }
+
+      // Publish the block before hiding the raw pointer
+      table->compressed[i].store(block, std::memory_order_release);
+      table->slots[i].store(nullptr, std::memory_order_release);
+      states[i] = ChunkState::Compressed;
+      compressedBytes += block->MemoryBytes();
+      saved += sizeof(SignalChunk) - block->MemoryBytes();
+      released.push_back(raw);
+    }
+    if (!released.empty()) {
+      GetSignalEpochs().Retire([released]() {
+        for (SignalChunk* chunk : released) GetSignalChunkPool().Release(chunk);
+      });
+    }
+    return saved;
+  }
+
+  // Allocate future chunks in segment files under `dir` (empty = heap).
+  // Chunks that already exist stay where they are.
+  void SetBacking(const std::string& dir) {
+    backingDir = dir;
+  }
+
+  const std::string& Backing() const { return backingDir; }
+
+  size_t ChunkCount() const { return chunkCount; }
+  size_t CapacitySamples() const { return chunkCount * kSignalChunkSamples; }
+  size_t SpilledChunks() const { return std::count(states.begin(), states.end(), ChunkState::Spilled); }
+  size_t CompressedChunks() const { return std::count(states.begin(), states.end(), ChunkState::Compressed); }
+  size_t SpilledBytes() const { return SpilledChunks() * sizeof(SignalChunk); }
+  size_t CompressedBytes() const { return compressedBytes; }
+  size_t MappedChunks() const { return std::count(states.begin(), states.end(), ChunkState::Mapped); }
+  size_t MappedBytes() const { return MappedChunks() * sizeof(SignalChunk); }
+
+  // Heap bytes: resident chunks plus compressed blocks
+  size_t MemoryBytes() const {
+    return (chunkCount - SpilledChunks() - CompressedChunks() - MappedChunks()) * sizeof(SignalChunk) +
+           compressedBytes;
+  }
+
+private:
+  bool IsResident(size_t i) const {
+    return states[i] == ChunkState::Resident || states[i] == ChunkState::Incompressible;
+  }
+
+  static double FirstX(const ChunkDirectory* dir, size_t idx) {
+    if (const SignalChunk* chunk = dir->Get(idx)) return chunk->x[0];
+    return dir->GetCompressed(idx)->firstX;
+  }
+
+  double Sample(size_t i, bool wantX) const {
+    const ChunkDirectory* dir = directory.load(std::memory_order_acquire);
+    size_t idx = i / kSignalChunkSamples;
+    size_t slot = i % kSignalChunkSamples;
+    if (const SignalChunk* chunk = dir->Get(idx)) {
+      return wantX ? chunk->x[slot] : chunk->y[slot];
+    }
+    std::shared_ptr<const SignalChunk> decoded = GetDecodedChunkCache().Get(*dir->GetCompressed(idx));
+    return wantX ? decoded->x[slot] : decoded->y[slot];
+  }
+
+  void Steal(ChunkedSeries& other) {
+    directory.store(other.directory.exchange(nullptr));
+    chunkCount = other.chunkCount;
+    count = other.count;
+    states = std::move(other.states);
+    mappedFiles = std::move(other.mappedFiles);
+    compressedBytes = other.compressedBytes;
+    backingDir = std::move(other.backingDir);
+    other.chunkCount = 0;
+    other.count = 0;
+    other.states.clear();
+    other.mappedFiles.clear();
+    other.compressedBytes = 0;
+    other.backingDir.clear();
+  }
+
+  void AddChunk() {
+    ChunkDirectory* dir = directory.load(std::memory_order_relaxed);
+    if (!dir || chunkCount == dir->capacity) {
+      ChunkDirectory* grown = new ChunkDirectory(dir ? dir->capacity * 2 : 16);
+      for (size_t i = 0; i < chunkCount; i++) {
+        grown->slots[i].store(dir->Get(i), std::memory_order_relaxed);
+        grown->compressed[i].store(dir->GetCompressed(i), std::memory_order_relaxed);
+      }
+      directory.store(grown, std::memory_order_release);
+      if (dir) {
+        GetSignalEpochs().Retire([dir]() { delete dir; });
+      }
+      dir = grown;
+    }
+    if (SignalChunk* mapped = NextMappedChunk()) {
+      dir->slots[chunkCount++].store(mapped, std::memory_order_release);
+      states.push_back(ChunkState::Mapped);
+      return;
+    }
+    dir->slots[chunkCount++].store(GetSignalChunkPool().Acquire(), std::memory_order_release);
+    states.push_back(ChunkState::Resident);
+  }
+
+  // Next chunk from the shared segment files (see OfflineStorage). Returns
+  // nullptr for heap backing or if no segment can be created (the series
+  // then falls back to the heap).
+  SignalChunk* NextMappedChunk() {
+    if (backingDir.empty()) return nullptr;
+    std::shared_ptr<MappedFile> file;
+    SignalChunk* chunk = GetOfflineStorage().AllocateMapped(backingDir, file);
+    if (!chunk) {
+      printf("[SignalStorage] Falling back to heap storage (cache directory %s unusable)\n",
+             backingDir.c_str());
+      backingDir.clear();
+      return nullptr;
+    }
+    if (std::find(mappedFiles.begin(), mappedFiles.end(), file) == mappedFiles.end()) {
+      mappedFiles.push_back(file);
+    }
+    return chunk;
+  }
+
+  std::atomic<ChunkDirectory*> directory{nullptr};
+  size_t chunkCount = 0;
+  size_t count = 0;
+  std::vector<ChunkState> states;                         // Per chunk storage tier
+  std::vector<std::shared_ptr<MappedFile>> mappedFiles;   // Spill and segment files, kept open while referenced
+  size_t compressedBytes = 0;
+  std::string backingDir;          // Cache directory for new chunks (empty = heap)
+};
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// -------------------------------------------------------------------------
+// LOCK-FREE SIGNAL PUBLICATION
+// -------------------------------------------------------------------------
+// Each signal has a single writer (the ingest path). Renderers and the UI
+// side of analysis updates still run inside the frame's stateMutex section
+// and use the writer's accessors; analysis jobs only ever see copies. This
+// file covers readers that don't take stateMutex (today the Lua queries
+// get_signal/get_signal_history, through Signal::ReadLatest/CopyTail):
+//
+//   - SignalPublication is a seqlock around the signal's bookkeeping (size,
+//     offset, ring capacity, totalCount) and ring storage pointers. Readers
+//     always get a consistent snapshot and never read the writer's fields.
+//   - SignalEpochs defers freeing of storage the writer unlinks (chunks
+//     released by Clear, outgrown chunk directories) until every reader that
+//     could still be looking at it has left its read section.
+//
+// Sample values in the online ring can still be overwritten while a reader
+// copies them. Both sides use relaxed atomic accesses (MirrorRing::Put and
+// CopyRelaxed), and the reader detects an overwrite by re-reading the
+// snapshot afterwards (see Signal::CopyTail).
+
+// Consistent view of a signal's bookkeeping at one instant
+struct SignalSnapshot {
+  size_t size = 0;          // Logical sample count
+  size_t offset = 0;        // Ring index of the oldest sample (ONLINE)
+  size_t capacity = 0;      // Samples written before the ring overwrites one (ONLINE)
+  uint64_t totalCount = 0;  // Absolute index of the next sample
+  uint32_t generation = 0;  // Bumped whenever storage is cleared or re-laid out
+  bool online = true;       // Ring (ONLINE) or chunked (OFFLINE) layout
+  const double* ringX = nullptr; // Ring storage (ONLINE)
+  const double* ringY = nullptr;
+};
+
+class SignalPublication {
+public:
+  SignalPublication() = default;
+
+  // Moves only happen with the registry locked (no concurrent readers)
+  SignalPublication(SignalPublication&& other) noexcept { CopyFrom(other); }
+  SignalPublication& operator=(SignalPublication&& other) noexcept {
+    CopyFrom(other);
+    return *this;
+  }
+
+  // Writer: open a write section (sequence becomes odd)
+  void BeginWrite() {
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  // Writer: publish the new state and close the write section
+  void EndWrite(const SignalSnapshot& s) {
+    size.store(s.size, std::memory_order_relaxed);
+    offset.store(s.offset, std::memory_order_relaxed);
+    capacity.store(s.capacity, std::memory_order_relaxed);
+    totalCount.store(s.totalCount, std::memory_order_relaxed);
+    generation.store(s.generation, std::memory_order_relaxed);
+    online.store(s.online, std::memory_order_relaxed);
+    ringX.store(s.ringX, std::memory_order_relaxed);
+    ringY.store(s.ringY, std::memory_order_relaxed);
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // Reader: retry until no write section overlapped the read
+  SignalSnapshot Read() const {
+    for (;;) {
+      uint32_t before = seq.load(std::memory_order_acquire);
+      if (before & 1) continue;
+      SignalSnapshot s;
+      s.size = size.load(std::memory_order_relaxed);
+      s.offset = offset.load(std::memory_order_relaxed);
+      s.capacity = capacity.load(std::memory_order_relaxed);
+      s.totalCount = totalCount.load(std::memory_order_relaxed);
+      s.generation = generation.load(std::memory_order_relaxed);
+      s.online = online.load(std::memory_order_relaxed);
+      s.ringX = ringX.load(std::memory_order_relaxed);
+      s.ringY = ringY.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq.load(std::memory_order_relaxed) == before) return s;
+    }
+  }
+
+private:
+  void CopyFrom(const SignalPublication& other) {
+    seq.store(other.seq.load() & ~1u);
+    size.store(other.size.load());
+    offset.store(other.offset.load());
+    capacity.store(other.capacity.load());
+    totalCount.store(other.totalCount.load());
+    generation.store(other.generation.load());
+    online.store(other.online.load());
+    ringX.store(other.ringX.load());
+    ringY.store(other.ringY.load());
+  }
+
+  std::atomic<uint32_t> seq{0};
+  std::atomic<size_t> size{0};
+  std::atomic<size_t> offset{0};
+  std::atomic<size_t> capacity{0};
+  std::atomic<uint64_t> totalCount{0};
+  std::atomic<uint32_t> generation{0};
+  std::atomic<bool> online{true};
+  std::atomic<const double*> ringX{nullptr};
+  std::atomic<const double*> ringY{nullptr};
+};
+
+// Seqlock around a small trivially copyable value (derived per-signal state
+// such as running statistics). Stored as relaxed atomic words so a torn read
+// is detected by the sequence check rather than being a data race.
+template <typename T>
+class SeqlockValue {
+  static_assert(std::is_trivially_copyable<T>::value, "SeqlockValue needs a trivially copyable type");
+  static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+public:
+  SeqlockValue() { Store(T{}); }
+
+  // Moves only happen with the registry locked (no concurrent readers)
+  SeqlockValue(SeqlockValue&& other) noexcept { Store(other.Load()); }
+  SeqlockValue& operator=(SeqlockValue&& other) noexcept {
+    Store(other.Load());
+    return *this;
+  }
+
+  // Writer
+  void Store(const T& value) {
+    uint64_t buffer[kWords] = {};
+    std::memcpy(buffer, &value, sizeof(T));
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < kWords; i++) words[i].store(buffer[i], std::memory_order_relaxed);
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // Reader: retry until no Store overlapped the read
+  T Load() const {
+    uint64_t buffer[kWords];
+    for (;;) {
+      uint32_t before = seq.load(std::memory_order_acquire);
+      if (before & 1) continue;
+      for (size_t i = 0; i < kWords; i++) buffer[i] = words[i].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq.load(std::memory_order_relaxed) == before) break;
+    }
+    T value;
+    std::memcpy(&value, buffer, sizeof(T));
+    return value;
+  }
+
+private:
+  std::atomic<uint32_t> seq{0};
+  std::atomic<uint64_t> words[kWords];
+};
+
+// Epoch-based deferred reclamation shared by all signals
+class SignalEpochs {
+public:
+  // Reader: enter a read section, returns the slot to pass to Exit()
+  int Enter() {
+    for (;;) {
+      uint64_t e = epoch.load();
+      int slot = (int)(e & 1);
+      readers[slot].fetch_add(1);
+      if (epoch.load() == e) return slot;
+      readers[slot].fetch_sub(1);
+    }
+  }
+
+  void Exit(int slot) { readers[slot].fetch_sub(1); }
+
+  // Writer: run fn once no reader can still reach the retired object
+  void Retire(std::function<void()> fn) {
+    std::lock_guard<std::mutex> lock(mutex);
+    retired.push_back({epoch.load(), std::move(fn)});
+  }
+
+  // Writer thread, once per frame: advance the epoch if the previous one has
+  // drained, then free everything retired two or more epochs ago
+  void Collect() {
+    uint64_t e = epoch.load();
+    if (readers[(e + 1) & 1].load() == 0) {
+      epoch.store(++e);
+    }
+
+    std::vector<std::function<void()>> ready;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      size_t kept = 0;
+      for (auto& item : retired) {
+        if (item.first + 2 <= e) {
+          ready.push_back(std::move(item.second));
+        } else {
+          retired[kept++] = std::move(item);
+        }
+      }
+      retired.resize(kept);
+    }
+    for (auto& fn : ready) fn();
+  }
+
+  // Shutdown only (no readers left): free everything immediately
+  void Drain() {
+    std::vector<std::pair<uint64_t, std::function<void()>>> all;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      all.swap(retired);
+    }
+    for (auto& item : all) item.second();
+  }
+
+  size_t PendingCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return retired.size();
+  }
+
+private:
+  std::atomic<uint64_t> epoch{0};
+  std::atomic<int> readers[2] = {{0}, {0}};
+  std::mutex mutex;
+  std::vector<std::pair<uint64_t, std::function<void()>>> retired;
+};
+
+inline SignalEpochs& GetSignalEpochs() {
+  static SignalEpochs epochs;
+  return epochs;
+}
+
+// RAII read section
+class EpochGuard {
+public:
+  EpochGuard() : slot(GetSignalEpochs().Enter()) {}
+  ~EpochGuard() { GetSignalEpochs().Exit(slot); }
+  EpochGuard(const EpochGuard&) = delete;
+  EpochGuard& operator=(const EpochGuard&) = delete;
+
+private:
+  int slot;
+};
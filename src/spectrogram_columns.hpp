@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// -------------------------------------------------------------------------
+// SPECTROGRAM COLUMN RING
+// -------------------------------------------------------------------------
+// Completed STFT columns of one spectrogram window, oldest first. Column k
+// is the spectrum of absolute samples [k * hop, k * hop + fftSize), so a
+// column never changes once computed: as the signal streams in, new hops are
+// pushed at the back and columns that slid out of the time window are popped
+// from the front (scrubbing an offline window back does the reverse).
+//
+// Storage is one block of `capacity` columns of `bins` magnitudes each,
+// used as a ring; it only grows when the time window needs more columns.
+// Each column is stored highest frequency first, so the block is exactly a
+// column-major heatmap: ImPlot draws it (ImPlotHeatmapFlags_ColMajor) with no
+// transpose, as at most two runs when the ring wraps (ForEachRun).
+
+class SpectrogramColumns {
+public:
+  // Drop all columns and switch to `bins` magnitudes per column
+  void Reset(int bins) {
+    numBins = std::max(bins, 1);
+    capacity = 0;
+    head = count = 0;
+    first = 0;
+    mags.clear();
+    times.clear();
+  }
+
+  // Drop all columns, keep the layout and memory
+  void Clear() {
+    head = count = 0;
+    first = 0;
+  }
+
+  int Bins() const { return numBins; }
+  size_t Count() const { return count; }
+  bool Empty() const { return count == 0; }
+  int64_t FirstIndex() const { return first; }                 // Hop index of the oldest column
+  int64_t EndIndex() const { return first + (int64_t)count; }  // One past the newest
+
+  // Room for column `index`, which must directly follow the newest one (or
+  // be any index when empty). Fill the returned numBins magnitudes.
+  double* PushBack(int64_t index, double time) {
+    if (count == 0) first = index;
+    Reserve(count + 1);
+    size_t slot = (head + count) % capacity;
+    count++;
+    times[slot] = time;
+    return &mags[slot * numBins];
+  }
+
+  // Room for column FirstIndex() - 1
+  double* PushFront(double time) {
+    Reserve(count + 1);
+    head = (head + capacity - 1) % capacity;
+    count++;
+    first--;
+    times[head] = time;
+    return &mags[head * numBins];
+  }
+
+  void PopFront(size_t n) {
+    n = std::min(n, count);
+    head = capacity ? (head + n) % capacity : 0;
+    count -= n;
+    first += (int64_t)n;
+  }
+
+  void PopBack(size_t n) { count -= std::min(n, count); }
+
+  // Grow to at least n columns, unwrapping the ring (oldest column first).
+  // Pointers returned by PushBack/PushFront stay valid until the next growth.
+  void Reserve(size_t n) {
+    if (n <= capacity) return;
+    size_t newCapacity = std::max<size_t>({n, capacity * 2, 16});
+    std::vector<double> newMags(newCapacity * numBins);
+    std::vector<double> newTimes(newCapacity);
+    for (size_t i = 0; i < count; i++) {
+      size_t slot = (head + i) % capacity;
+      std::copy_n(&mags[slot * numBins], numBins, &newMags[i * numBins]);
+      newTimes[i] = times[slot];
+    }
+    mags.swap(newMags);
+    times.swap(newTimes);
+    capacity = newCapacity;
+    head = 0;
+  }
+
+  // i-th column from the oldest
+  const double* Column(size_t i) const { return &mags[((head + i) % capacity) * numBins]; }
+  double Time(size_t i) const { return times[(head + i) % capacity]; }
+  double FrontTime() const { return Time(0); }
+  double BackTime() const { return Time(count - 1); }
+
+  // fn(const double* mags, size_t first, size_t n) for each stored run of
+  // columns in time order; `first` is the run's offset from the oldest
+  template <typename Fn>
+  void ForEachRun(Fn&& fn) const {
+    if (count == 0) return;
+    size_t firstRun = std::min(count, capacity - head);
+    fn(&mags[head * numBins], (size_t)0, firstRun);
+    if (firstRun < count) fn(&mags[0], firstRun, count - firstRun);
+  }
+
+  size_t Bytes() const { return (mags.capacity() + times.capacity()) * sizeof(double); }
+
+private:
+  int numBins = 1;
+  size_t capacity = 0;
+  size_t head = 0;  // Slot of the oldest column
+  size_t count = 0;
+  int64_t first = 0;
+  std::vector<double> mags;  // capacity x numBins, one column per slot
+  std::vector<double> times; // Center time of each slot's column
+};
@@ -1,6 +1,11 @@
 #pragma once
 #include <string>
 #include <vector>
+#include "mirror_ring.hpp"
+#include "signal_storage.hpp"
+#include "signal_lod.hpp"
+#include "signal_stats.hpp"
+#include "signal_sync.hpp"
 
 // Playback mode enum
 enum class PlaybackMode {
@@ -9,51 +14,599 @@ enum class PlaybackMode {
 };
 
 // A single signal (e.g., "IMU.AccelX") holding its own history
+//
+// Storage depends on the mode:
+//   ONLINE  - ringX/ringY form a circular buffer holding the newest maxSize
+//             samples (offset = oldest sample), normally backed by a mirrored
+//             mapping (mirror_ring.hpp) so the live history is the contiguous
+//             run [offset, offset + Size()). The storage wraps at its own
+//             capacity, which may be a little larger than maxSize.
+//   OFFLINE - samples are appended to pooled fixed-size chunks (see signal_storage.hpp),
+//             or to memory-mapped segment files when the out-of-core backend is selected
+//
+// Readers should use the logical accessors (Size/XAt/YAt/ForEachSpan), which
+// present both layouts in chronological order (index 0 = oldest sample).
+// Every sample is also folded into a min/max LOD pyramid (signal_lod.hpp)
+// so zoomed-out plots can be drawn from a bounded number of points, and into
+// running statistics (signal_stats.hpp) so nothing rescans for min/max/RMS.
+//
+// Those accessors belong to the writer (or anyone holding stateMutex, as all
+// renderers do). Code that can't take the lock reads through
+// Snapshot/ReadLatest/CopyTail, which work from a seqlock-published snapshot
+// and never block the writer (signal_sync.hpp).
 struct Signal {
   std::string name;
   int offset;
-  std::vector<double> dataX; // Time
-  std::vector<double> dataY; // Value
-  int maxSize;
+  MirrorRing ringX;          // Time (ONLINE ring, allocated on first sample)
+  MirrorRing ringY;          // Value (ONLINE ring)
+  size_t ringSize = 0;       // Valid samples in the ring
+  ChunkedSeries chunks;      // OFFLINE storage
+  int maxSize;               // Samples kept in the ring (as configured)
+  int nominalSize;           // Ring size at creation (maxSize may be shrunk by the memory budget)
   PlaybackMode mode;
+  uint64_t totalCount = 0;   // Samples added since the last Clear (absolute index of the next sample)
+  MinMaxPyramid lod;         // Min/max summary for decimated plotting
+  uint32_t generation = 0;   // Bumped by Clear/SetMode so readers can detect a reset
+  size_t decimatedPrefix = 0; // OFFLINE: leading samples already downsampled by the memory budget
+  uint64_t lastInversion = 0; // Absolute index of the newest sample whose time went backwards (0 = none)
+  double lastX = 0.0;
+  RunningStats stats;             // Every sample since the last Clear
+  RunningStats windowStats;       // ONLINE: samples currently in the ring (min/max unused)
+  WindowedExtrema windowExtrema;  // ONLINE: min/max of the ring contents
+  SampleRateEstimate rate;        // Smoothed sample interval/jitter since the last Clear
+  SignalPublication published;
+  SeqlockValue<SignalStats> publishedStats;
 
   Signal(std::string n = "", int size = 10000, PlaybackMode m = PlaybackMode::ONLINE)
-      : name(n), maxSize(size), offset(0), mode(m) {
-    if (mode == PlaybackMode::ONLINE) {
-      dataX.reserve(maxSize);
-      dataY.reserve(maxSize);
-    }
+      : name(n), offset(0), mode(m) {
+    maxSize = std::max(size, 1);
+    nominalSize = maxSize;
+    ResetLod();
+    ApplyOfflineBacking();
+    published.BeginWrite();
+    published.EndWrite(Bookkeeping());
   }
 
+  Signal(Signal&&) = default;
+  Signal& operator=(Signal&&) = default;
+
   void AddPoint(double x, double y) {
+    bool lapped = false;
+    published.BeginWrite();
     if (mode == PlaybackMode::ONLINE) {
       // Online mode: circular buffer with fixed size
-      if (dataX.size() < maxSize) {
-        dataX.push_back(x);
-        dataY.push_back(y);
-      } else {
-        dataX[offset] = x;
-        dataY[offset] = y;
-        offset = (offset + 1) % maxSize;
+      if (!ringX.IsAllocated()) AllocateRings(ringX, ringY, (size_t)maxSize);
+      size_t capacity = ringX.Capacity();
+      if (ringSize == (size_t)maxSize) {
+        // Full: drop the oldest sample (its slot may be the one written next)
+        windowStats.Remove(ringY[offset]);
+        offset = (int)((offset + 1) % capacity);
+        lapped = (offset == 0);
+        ringSize--;
       }
+      size_t head = ((size_t)offset + ringSize) % capacity;
+      ringX.Put(head, x);
+      ringY.Put(head, y);
+      ringSize++;
     } else {
-      // Offline mode: grow indefinitely
-      dataX.push_back(x);
-      dataY.push_back(y);
+      // Offline mode: grow chunk by chunk
+      chunks.Append(x, y);
     }
+    lod.Add(totalCount, x, y);
+    stats.Add(y);
+    if (mode == PlaybackMode::ONLINE) {
+      windowStats.Add(y);
+      windowExtrema.Push(totalCount, y);
+      windowExtrema.Evict(totalCount + 1 - ringSize);
+      // Once per lap, recompute the window sums exactly so removals can't drift
+      if (lapped) RecomputeWindowStats(false);
+    }
+    if (totalCount > 0) {
+      if (x < lastX) lastInversion = totalCount;
+      rate.Add(x - lastX);
+    }
+    lastX = x;
+    totalCount++;
+    published.EndWrite(Bookkeeping());
+    publishedStats.Store(StatsSummary());
   }
 
   void Clear() {
-    dataX.clear();
-    dataY.clear();
+    published.BeginWrite();
+    ringSize = 0;
+    chunks.Clear();
+    ApplyOfflineBacking();
     offset = 0;
+    totalCount = 0;
+    decimatedPrefix = 0;
+    lastInversion = 0;
+    generation++;
+    ResetLod();
+    stats.Reset();
+    rate.Reset();
+    RecomputeWindowStats(true);
+    published.EndWrite(Bookkeeping());
+  }
+
+  void ResetLod() {
+    lod.Reset(mode == PlaybackMode::ONLINE ? (size_t)maxSize : 0);
   }
 
   void SetMode(PlaybackMode m) {
-    mode = m;
-    if (mode == PlaybackMode::ONLINE && dataX.capacity() < maxSize) {
-      dataX.reserve(maxSize);
-      dataY.reserve(maxSize);
+    if (m != mode && !Empty()) {
+      // Carry existing samples over to the new layout (chronological order)
+      std::vector<double> xs, ys;
+      xs.reserve(Size());
+      ys.reserve(Size());
+      ForEachSpan(0, Size(), [&](const double* x, const double* y, size_t n) {
+        xs.insert(xs.end(), x, x + n);
+        ys.insert(ys.end(), y, y + n);
+      });
+      Clear();
+      published.BeginWrite();
+      mode = m;
+      ResetLod();
+      ApplyOfflineBacking();
+      published.EndWrite(Bookkeeping());
+      size_t first = (mode == PlaybackMode::ONLINE && xs.size() > (size_t)maxSize) ? xs.size() - maxSize : 0;
+      for (size_t i = first; i < xs.size(); i++) AddPoint(xs[i], ys[i]);
+      return;
+    }
+
+    if (m != mode) {
+      published.BeginWrite();
+      mode = m;
+      generation++;
+      ResetLod();
+      ApplyOfflineBacking();
+      RecomputeWindowStats(true);
+      published.EndWrite(Bookkeeping());
     }
   }
-};
\ No newline at end of file
+
+  // -----------------------------------------------------------------------
+  // Memory budget actions (see signal_budget.hpp)
+  // -----------------------------------------------------------------------
+  // Each one prepares the new storage first and swaps it in inside a single
+  // short write section; replaced storage is retired, so lock-free readers
+  // holding the old snapshot stay safe.
+
+  // ONLINE: change the ring size, keeping the newest samples
+  void ResizeHistory(int newMax) {
+    if (mode != PlaybackMode::ONLINE || newMax <= 0) return;
+    if (newMax == maxSize) return;
+
+    size_t keep = std::min(Size(), (size_t)newMax);
+    MirrorRing newX, newY;
+    AllocateRings(newX, newY, (size_t)newMax);
+    size_t written = 0;
+    ForEachSpan(Size() - keep, keep, [&](const double* x, const double* y, size_t n) {
+      for (size_t i = 0; i < n; i++, written++) {
+        newX.Put(written, x[i]);
+        newY.Put(written, y[i]);
+      }
+    });
+    MinMaxPyramid newLod;
+    newLod.Reset((size_t)newMax);
+    uint64_t newInversion = 0;
+    for (size_t i = 0; i < keep; i++) {
+      newLod.Add(i, newX[i], newY[i]);
+      if (i > 0 && newX[i] < newX[i - 1]) newInversion = i;
+    }
+
+    MirrorRing* oldX = new MirrorRing();
+    MirrorRing* oldY = new MirrorRing();
+    published.BeginWrite();
+    *oldX = std::move(ringX);
+    *oldY = std::move(ringY);
+    ringX = std::move(newX);
+    ringY = std::move(newY);
+    ringSize = keep;
+    offset = 0;
+    maxSize = newMax;
+    totalCount = keep;
+    lod = std::move(newLod);
+    lastInversion = newInversion;
+    generation++;
+    RecomputeWindowStats(true);
+    published.EndWrite(Bookkeeping());
+    GetSignalEpochs().Retire([oldX, oldY]() {
+      delete oldX;
+      delete oldY;
+    });
+  }
+
+  // OFFLINE: replace samples older than the newest keepRecent with one
+  // min/max pair per `factor` samples (spikes survive). Data that was already
+  // downsampled, spilled or stored in mapped column files is left alone
+  // (compressed chunks are decoded and rebuilt raw; CompressHistory picks
+  // them up again). Returns heap bytes released.
+  size_t DownsampleOld(size_t keepRecent, size_t factor) {
+    if (mode != PlaybackMode::OFFLINE || factor < 4 || chunks.SpilledChunks() > 0 ||
+        chunks.MappedChunks() > 0) {
+      return 0;
+    }
+    size_t total = Size();
+    if (total <= keepRecent) return 0;
+    size_t end = total - keepRecent;
+    if (end < decimatedPrefix + kSignalChunkSamples) return 0; // Not worth a rebuild yet
+
+    ChunkedSeries rebuilt;
+    auto append = [&](const double* x, const double* y, size_t n) {
+      for (size_t i = 0; i < n; i++) rebuilt.Append(x[i], y[i]);
+    };
+    ForEachSpan(0, decimatedPrefix, append);
+    for (size_t b = decimatedPrefix; b < end; b += factor) {
+      size_t n = std::min(factor, end - b);
+      LodBucket bucket{XAt(b), YAt(b), XAt(b), YAt(b)};
+      ForEachSpan(b, n, [&](const double* x, const double* y, size_t len) {
+        for (size_t i = 0; i < len; i++) {
+          if (y[i] < bucket.yMin) { bucket.yMin = y[i]; bucket.xMin = x[i]; }
+          if (y[i] > bucket.yMax) { bucket.yMax = y[i]; bucket.xMax = x[i]; }
+        }
+      });
+      if (bucket.xMin == bucket.xMax) {
+        rebuilt.Append(bucket.xMin, bucket.yMin);
+      } else if (bucket.xMin < bucket.xMax) {
+        rebuilt.Append(bucket.xMin, bucket.yMin);
+        rebuilt.Append(bucket.xMax, bucket.yMax);
+      } else {
+        rebuilt.Append(bucket.xMax, bucket.yMax);
+        rebuilt.Append(bucket.xMin, bucket.yMin);
+      }
+    }
+    size_t newPrefix = rebuilt.Size();
+    ForEachSpan(end, total - end, append);
+
+    MinMaxPyramid newLod;
+    newLod.Reset(0);
+    uint64_t newInversion = 0;
+    uint64_t index = 0;
+    double prevX = 0.0;
+    rebuilt.ForEachSpan(0, rebuilt.Size(), [&](const double* x, const double* y, size_t n) {
+      for (size_t k = 0; k < n; k++, index++) {
+        newLod.Add(index, x[k], y[k]);
+        if (index > 0 && x[k] < prevX) newInversion = index;
+        prevX = x[k];
+      }
+    });
+
+    size_t before = MemoryBytes();
+    published.BeginWrite();
+    chunks = std::move(rebuilt); // Old chunks are retired, not freed
+    totalCount = chunks.Size();
+    lod = std::move(newLod);
+    lastInversion = newInversion;
+    decimatedPrefix = newPrefix;
+    generation++;
+    published.EndWrite(Bookkeeping());
+    size_t after = MemoryBytes();
+    return before > after ? before - after : 0;
+  }
+
+  // OFFLINE: move full chunks into a temporary mapped file in `dir`
+  size_t SpillToDisk(const std::string& dir) {
+    if (mode != PlaybackMode::OFFLINE) return 0;
+    return chunks.SpillFullChunks(dir);
+  }
+
+  // OFFLINE: Gorilla-compress old full chunks (lossless). Returns heap bytes released.
+  size_t CompressHistory(size_t maxChunks, size_t keepRawChunks) {
+    if (mode != PlaybackMode::OFFLINE) return 0;
+    return chunks.CompressFullChunks(maxChunks, keepRawChunks);
+  }
+
+  size_t SpilledBytes() const { return chunks.SpilledBytes(); }
+  size_t MappedBytes() const { return chunks.MappedBytes(); }
+
+  // -----------------------------------------------------------------------
+  // Logical (chronological) read access
+  // -----------------------------------------------------------------------
+
+  size_t Size() const {
+    return mode == PlaybackMode::ONLINE ? ringSize : chunks.Size();
+  }
+
+  bool Empty() const { return Size() == 0; }
+
+  double XAt(size_t i) const {
+    if (mode == PlaybackMode::OFFLINE) return chunks.X(i);
+    return ringX[(size_t)offset + i];
+  }
+
+  double YAt(size_t i) const {
+    if (mode == PlaybackMode::OFFLINE) return chunks.Y(i);
+    return ringY[(size_t)offset + i];
+  }
+
+  // -----------------------------------------------------------------------
+  // Time index
+  // -----------------------------------------------------------------------
+  // Timestamps are normally non-decreasing, which makes window lookups a
+  // binary search. AddPoint remembers the newest sample where time went
+  // backwards; only the samples before it need a linear scan.
+
+  // Logical index where the time-ordered tail begins (0 = fully ordered)
+  size_t SortedFrom() const {
+    uint64_t base = totalCount - Size();
+    return lastInversion > base ? (size_t)(lastInversion - base) : 0;
+  }
+
+  bool IsMonotonic() const { return SortedFrom() == 0; }
+
+  // First logical index with XAt(i) >= t (Size() if none)
+  size_t LowerBound(double t) const {
+    return TimeSearch([t](double x) { return x < t; });
+  }
+
+  // First logical index with XAt(i) > t (Size() if none)
+  size_t UpperBound(double t) const {
+    return TimeSearch([t](double x) { return x <= t; });
+  }
+
+  // Same, searching only the ordered samples [from, Size()); `from` must be
+  // at least SortedFrom(). Returns Size() if none.
+  size_t LowerBound(double t, size_t from) const {
+    return SortedSearch(from, [t](double x) { return x < t; });
+  }
+  size_t UpperBound(double t, size_t from) const {
+    return SortedSearch(from, [t](double x) { return x <= t; });
+  }
+
+  // Most recent sample (caller must check Empty() first)
+  double LatestX() const { return XAt(Size() - 1); }
+  double LatestY() const { return YAt(Size() - 1); }
+
+  // Visit logical samples [first, first + count) as contiguous runs.
+  // fn(const double* x, const double* y, size_t len) is called once per run:
+  // a single run for the mirrored ring buffer (two if a plain ring wraps),
+  // one per chunk offline.
+  template <typename Fn>
+  void ForEachSpan(size_t first, size_t count, Fn&& fn) const {
+    size_t total = Size();
+    if (first >= total) return;
+    count = std::min(count, total - first);
+
+    if (mode == PlaybackMode::OFFLINE) {
+      chunks.ForEachSpan(first, count, fn);
+      return;
+    }
+
+    size_t start = ((size_t)offset + first) % ringX.Capacity();
+    size_t run = ringX.Contiguous(start, count) ? count : ringX.Capacity() - start;
+    fn(ringX.Data() + start, ringY.Data() + start, run);
+    if (run < count) fn(ringX.Data(), ringY.Data(), count - run);
+  }
+
+  // Zero-copy pointers to logical samples [first, first + count). Online
+  // unless a plain (unmirrored) ring wraps inside the range; offline only
+  // when the range lies in one raw chunk.
+  bool Contiguous(size_t first, size_t count, const double*& x, const double*& y) const {
+    if (first + count > Size()) return false;
+    if (mode == PlaybackMode::ONLINE) {
+      if (count == 0) return false;
+      size_t start = ((size_t)offset + first) % ringX.Capacity();
+      if (!ringX.Contiguous(start, count)) return false;
+      x = ringX.Data() + start;
+      y = ringY.Data() + start;
+      return true;
+    }
+    return chunks.Contiguous(first, count, x, y);
+  }
+
+  // Append a min/max-decimated copy of logical samples [first, first + count)
+  // to outX/outY, using about two points per bucket and at most maxBuckets
+  // pyramid buckets. Partial buckets at both ends are summarized from the raw
+  // samples. Returns false (appending nothing) when the raw samples already fit.
+  bool DecimateMinMax(size_t first, size_t count, size_t maxBuckets,
+                      std::vector<double>& outX, std::vector<double>& outY) const {
+    int level = lod.ChooseLevel(count, maxBuckets);
+    if (level < 0) return false;
+
+    uint64_t factor = kLodFactors[level];
+    uint64_t base = totalCount - Size();
+    uint64_t a0 = base + first;
+    uint64_t a1 = a0 + count;
+    uint64_t b0 = (a0 + factor - 1) / factor; // First bucket fully inside the range
+    uint64_t b1 = a1 / factor;                // One past the last full bucket
+    if (b1 <= b0) return false;
+
+    auto emitPair = [&](double xMin, double yMin, double xMax, double yMax) {
+      // Keep the two extremes in time order so the line doesn't double back
+      if (xMin <= xMax) {
+        outX.push_back(xMin); outY.push_back(yMin);
+        outX.push_back(xMax); outY.push_back(yMax);
+      } else {
+        outX.push_back(xMax); outY.push_back(yMax);
+        outX.push_back(xMin); outY.push_back(yMin);
+      }
+    };
+    auto emitPartial = [&](uint64_t from, uint64_t to) {
+      if (to <= from) return;
+      LodBucket b{XAt(from - base), YAt(from - base), XAt(from - base), YAt(from - base)};
+      ForEachSpan(from - base, to - from, [&](const double* x, const double* y, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+          if (y[i] < b.yMin) { b.yMin = y[i]; b.xMin = x[i]; }
+          if (y[i] > b.yMax) { b.yMax = y[i]; b.xMax = x[i]; }
+        }
+      });
+      emitPair(b.xMin, b.yMin, b.xMax, b.yMax);
+    };
+
+    outX.reserve(outX.size() + (b1 - b0 + 2) * 2);
+    outY.reserve(outY.size() + (b1 - b0 + 2) * 2);
+    emitPartial(a0, b0 * factor);
+    for (uint64_t b = b0; b < b1; b++) {
+      const LodBucket& bucket = lod.Bucket(level, b);
+      emitPair(bucket.xMin, bucket.yMin, bucket.xMax, bucket.yMax);
+    }
+    emitPartial(b1 * factor, a1);
+    return true;
+  }
+
+  // -----------------------------------------------------------------------
+  // Lock-free read access (any thread)
+  // -----------------------------------------------------------------------
+
+  SignalSnapshot Snapshot() const { return published.Read(); }
+
+  // Running statistics. windowed=false covers every sample since the last
+  // Clear; windowed=true only the samples currently held (the ring contents
+  // online, everything offline).
+  RunningStats Stats(bool windowed) const {
+    SignalStats s = publishedStats.Load();
+    return windowed ? s.window : s.total;
+  }
+
+  // Smoothed sampling interval, jitter and last gap (updated by AddPoint)
+  SampleRateEstimate Rate() const { return publishedStats.Load().rate; }
+
+  // Newest sample; false if the signal is empty
+  bool ReadLatest(double& x, double& y) const {
+    double tx, ty;
+    if (CopyTail(1, &tx, &ty) == 0) return false;
+    x = tx;
+    y = ty;
+    return true;
+  }
+
+  // Copy up to n of the newest samples (oldest first) into outX/outY, which
+  // must hold n values. Returns the number copied. Retries if the writer
+  // overwrote or reset the range while it was being copied.
+  size_t CopyTail(size_t n, double* outX, double* outY) const {
+    EpochGuard guard;
+    for (;;) {
+      SignalSnapshot snap = published.Read();
+      size_t count = std::min(n, snap.size);
+      size_t first = snap.size - count;
+      size_t written = 0;
+      auto copy = [&](const double* x, const double* y, size_t len) {
+        std::copy(x, x + len, outX + written);
+        std::copy(y, y + len, outY + written);
+        written += len;
+      };
+
+      if (snap.online) {
+        // The newest `count` samples, split where the storage wraps (the
+        // mirror aliases the second run, a plain ring needs it). The writer
+        // may be overwriting them: relaxed atomic loads, checked below.
+        if (count > 0) {
+          size_t start = (snap.offset + first) % snap.capacity;
+          size_t run = std::min(count, snap.capacity - start);
+          MirrorRing::CopyRelaxed(snap.ringX + start, run, outX);
+          MirrorRing::CopyRelaxed(snap.ringY + start, run, outY);
+          MirrorRing::CopyRelaxed(snap.ringX, count - run, outX + run);
+          MirrorRing::CopyRelaxed(snap.ringY, count - run, outY + run);
+        }
+      } else {
+        // Published chunk samples are never rewritten in place
+        chunks.ForEachSpan(first, count, copy, snap.size);
+      }
+
+      // Valid if nothing was reset and the ring hasn't lapped the oldest copied sample
+      std::atomic_thread_fence(std::memory_order_acquire);
+      SignalSnapshot after = published.Read();
+      uint64_t oldest = snap.totalCount - count;
+      if (after.generation == snap.generation &&
+          (!snap.online || after.totalCount <= oldest + (uint64_t)snap.capacity)) {
+        return count;
+      }
+    }
+  }
+
+  // Bytes currently held for sample storage
+  size_t MemoryBytes() const {
+    return ringX.MemoryBytes() + ringY.MemoryBytes() + chunks.MemoryBytes() + lod.MemoryBytes();
+  }
+
+  // Sample capacity of the current storage (ring size or allocated chunks)
+  size_t CapacitySamples() const {
+    return mode == PlaybackMode::ONLINE ? (size_t)maxSize : chunks.CapacitySamples();
+  }
+
+private:
+  // X and Y rings must share one layout (capacity and wrap point)
+  static void AllocateRings(MirrorRing& x, MirrorRing& y, size_t samples) {
+    x.Allocate(samples);
+    y.Allocate(samples);
+    if (x.IsMirrored() != y.IsMirrored()) {
+      x.Allocate(samples, false);
+      y.Allocate(samples, false);
+    }
+  }
+
+  // Rebuild the ring's window statistics from its contents (O(ring size));
+  // with extrema=true the min/max queues are rebuilt as well
+  void RecomputeWindowStats(bool extrema) {
+    windowStats.Reset();
+    if (extrema) windowExtrema.Clear();
+    if (mode != PlaybackMode::ONLINE) {
+      publishedStats.Store(StatsSummary());
+      return;
+    }
+    uint64_t index = totalCount - Size();
+    ForEachSpan(0, Size(), [&](const double*, const double* y, size_t n) {
+      for (size_t i = 0; i < n; i++, index++) {
+        windowStats.Add(y[i]);
+        if (extrema) windowExtrema.Push(index, y[i]);
+      }
+    });
+    publishedStats.Store(StatsSummary());
+  }
+
+  SignalStats StatsSummary() const {
+    SignalStats s;
+    s.total = stats;
+    s.rate = rate;
+    if (mode == PlaybackMode::ONLINE) {
+      s.window = windowStats;
+      s.window.min = windowExtrema.Min();
+      s.window.max = windowExtrema.Max();
+    } else {
+      s.window = stats;
+    }
+    return s;
+  }
+
+  // OFFLINE chunks follow the process-wide storage backend (see OfflineStorage)
+  void ApplyOfflineBacking() {
+    if (mode == PlaybackMode::OFFLINE) chunks.SetBacking(GetOfflineStorage().Directory());
+  }
+
+  // First index where before(XAt(i)) is false: linear over the unordered
+  // prefix, binary search over the ordered tail
+  template <typename Pred>
+  size_t TimeSearch(Pred before) const {
+    size_t lo = SortedFrom();
+    for (size_t i = 0; i < lo; i++) {
+      if (!before(XAt(i))) return i;
+    }
+    return SortedSearch(lo, before);
+  }
+
+  // Binary search over [lo, Size()); OFFLINE chunks are narrowed by their
+  // first timestamps before any chunk is decoded
+  template <typename Pred>
+  size_t SortedSearch(size_t lo, Pred before) const {
+    if (mode == PlaybackMode::OFFLINE) return chunks.Search(lo, Size(), before);
+    size_t hi = Size();
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (before(XAt(mid))) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+  }
+
+  SignalSnapshot Bookkeeping() const {
+    SignalSnapshot s;
+    s.size = Size();
+    s.offset = (size_t)offset;
+    s.capacity = ringX.Capacity();
+    s.totalCount = totalCount;
+    s.generation = generation;
+    s.online = (mode == PlaybackMode::ONLINE);
+    s.ringX = ringX.Data();
+    s.ringY = ringY.Data();
+    return s;
+  }
+};
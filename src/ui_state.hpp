@@ -56,6 +56,10 @@ struct UIPlotState {
   std::unordered_set<std::string> activeSignals;
   std::mutex activeSignalsMutex;
 
+  // Signals drawn by visible, unpaused windows (frame pacing redraws when
+  // these get new samples; UI thread only)
+  std::vector<std::string> visibleSignals;
+
   // Pending action requests (handled in main loop before NewFrame)
   std::string pendingLoadFilename;
   bool managedByImGui = false;
@@ -85,6 +89,42 @@ struct UIPlotState {
       }
   }
 
+  void refreshVisibleSignals() {
+      visibleSignals.clear();
+      for (const auto& p : activePlots) {
+          if (!p.visible || p.paused) continue;
+          visibleSignals.insert(visibleSignals.end(), p.signalNames.begin(), p.signalNames.end());
+      }
+      for (const auto& r : activeReadoutBoxes) {
+          if (r.visible && !r.signalName.empty()) visibleSignals.push_back(r.signalName);
+      }
+      for (const auto& xy : activeXYPlots) {
+          if (!xy.visible || xy.paused) continue;
+          if (!xy.xSignalName.empty()) visibleSignals.push_back(xy.xSignalName);
+          if (!xy.ySignalName.empty()) visibleSignals.push_back(xy.ySignalName);
+      }
+      for (const auto& h : activeHistograms) {
+          if (h.visible && !h.signalName.empty()) visibleSignals.push_back(h.signalName);
+      }
+      for (const auto& f : activeFFTs) {
+          if (f.visible && !f.signalName.empty()) visibleSignals.push_back(f.signalName);
+      }
+      for (const auto& s : activeSpectrograms) {
+          if (s.visible && !s.signalName.empty()) visibleSignals.push_back(s.signalName);
+      }
+  }
+
+  // Button clicks and Enter presses are seen by exactly one round of Lua
+  // frame callbacks, however many ingest ticks run between two frames
+  void consumeControlEvents() {
+      for (auto& b : activeButtons) {
+          if (b.wasClickedLastFrame) b.clicked = b.wasClickedLastFrame = false;
+      }
+      for (auto& t : activeTextInputs) {
+          if (t.wasEnterPressedLastFrame) t.enterPressed = t.wasEnterPressedLastFrame = false;
+      }
+  }
+
   bool isSignalActive(const std::string& name) {
       std::lock_guard<std::mutex> lock(activeSignalsMutex);
       return activeSignals.find(name) != activeSignals.end();
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SIGNAKIT_WINDOW_SSE 1
+#endif
+
+// -------------------------------------------------------------------------
+// FFT WINDOW FUNCTIONS
+// -------------------------------------------------------------------------
+// Window coefficients are computed once per (type, N) and cached, so
+// windowing a frame is one multiply per sample (4 or 8 at a time with
+// SSE/AVX) instead of a cosf() each. All windows are periodic (DFT-even),
+// which is the right form for spectral analysis.
+//
+// Each table carries its correction factors:
+//   - amplitudeCorrection = N / sum(w): a sine reads the same peak magnitude
+//     whatever the window (the FFT/spectrogram displays use this)
+//   - energyCorrection = sqrt(N / sum(w^2)): broadband power/RMS comes out
+//     the same whatever the window
+//   - enbw: equivalent noise bandwidth in bins, for PSD scaling
+//
+// The AVX kernel is used when the build targets AVX (-mavx, /arch:AVX);
+// x86 builds otherwise use SSE, anything else a plain loop.
+
+enum class WindowType {
+  Rectangular,
+  Hann,
+  Hamming,
+  BlackmanHarris,
+  FlatTop
+};
+
+// Combo labels, indexed by WindowType
+inline const char* const kWindowTypeLabels[] = { "Rectangular", "Hann", "Hamming", "Blackman-Harris", "Flat Top" };
+
+inline const char* WindowTypeName(WindowType type) {
+  switch (type) {
+    case WindowType::Rectangular: return "rectangular";
+    case WindowType::Hamming: return "hamming";
+    case WindowType::BlackmanHarris: return "blackman-harris";
+    case WindowType::FlatTop: return "flat-top";
+    default: return "hann";
+  }
+}
+
+inline WindowType WindowTypeFromName(const std::string& name) {
+  if (name == "rectangular") return WindowType::Rectangular;
+  if (name == "hamming") return WindowType::Hamming;
+  if (name == "blackman-harris") return WindowType::BlackmanHarris;
+  if (name == "flat-top") return WindowType::FlatTop;
+  return WindowType::Hann;
+}
+
+struct WindowTable {
+  WindowType type = WindowType::Rectangular;
+  std::vector<float> coeffs;
+  double sum = 0.0;              // sum(w)
+  double sumSquares = 0.0;       // sum(w^2)
+  double amplitudeCorrection = 1.0;
+  double energyCorrection = 1.0;
+  double enbw = 1.0;             // Equivalent noise bandwidth (bins)
+
+  int Size() const { return (int)coeffs.size(); }
+};
+
+// Cosine-sum coefficients a0..a4: w[n] = a0 - a1 cos(x) + a2 cos(2x) - a3 cos(3x) + a4 cos(4x)
+inline void WindowCosineTerms(WindowType type, double a[5]) {
+  a[0] = 1.0;
+  a[1] = a[2] = a[3] = a[4] = 0.0;
+  switch (type) {
+    case WindowType::Hann:
+      a[0] = 0.5; a[1] = 0.5;
+      break;
+    case WindowType::Hamming:
+      a[0] = 0.54; a[1] = 0.46;
+      break;
+    case WindowType::BlackmanHarris: // 4-term, -92 dB sidelobes
+      a[0] = 0.35875; a[1] = 0.48829; a[2] = 0.14128; a[3] = 0.01168;
+      break;
+    case WindowType::FlatTop: // Amplitude-accurate (< 0.01 dB scalloping)
+      a[0] = 0.21557895; a[1] = 0.41663158; a[2] = 0.277263158; a[3] = 0.083578947; a[4] = 0.006947368;
+      break;
+    default:
+      break;
+  }
+}
+
+inline std::unique_ptr<WindowTable> BuildWindowTable(WindowType type, int N) {
+  auto table = std::make_unique<WindowTable>();
+  table->type = type;
+  table->coeffs.resize(N);
+  double a[5];
+  WindowCosineTerms(type, a);
+  for (int n = 0; n < N; n++) {
+    double x = 2.0 * 3.14159265358979323846 * n / N;
+    double w = a[0] - a[1] * std::cos(x) + a[2] * std::cos(2 * x) - a[3] * std::cos(3 * x) + a[4] * std::cos(4 * x);
+    table->coeffs[n] = (float)w;
+    table->sum += w;
+    table->sumSquares += w * w;
+  }
+  if (N > 0 && table->sum != 0.0 && table->sumSquares > 0.0) {
+    table->amplitudeCorrection = N / table->sum;
+    table->energyCorrection = std::sqrt(N / table->sumSquares);
+    table->enbw = N * table->sumSquares / (table->sum * table->sum);
+  }
+  return table;
+}
+
+// Cached table for (type, N); the pointer stays valid for the program's life
+inline const WindowTable* GetWindowTable(WindowType type, int N) {
+  static std::mutex mutex;
+  static std::map<std::pair<int, int>, std::unique_ptr<WindowTable>> cache;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& slot = cache[{(int)type, N}];
+  if (!slot) slot = BuildWindowTable(type, N);
+  return slot.get();
+}
+
+// data[i] *= coeffs[i] for i < n
+inline void MultiplyFloats(float* data, const float* coeffs, int n) {
+  int i = 0;
+#if defined(__AVX__)
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), _mm256_loadu_ps(coeffs + i)));
+  }
+#elif defined(SIGNAKIT_WINDOW_SSE)
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), _mm_loadu_ps(coeffs + i)));
+  }
+#endif
+  for (; i < n; i++) data[i] *= coeffs[i];
+}
+
+// Window N samples in place (no-op for Rectangular)
+inline void ApplyWindow(float* data, int N, WindowType type) {
+  if (type == WindowType::Rectangular) return;
+  const WindowTable* table = GetWindowTable(type, N);
+  MultiplyFloats(data, table->coeffs.data(), N);
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// -------------------------------------------------------------------------
+// WORKER POOL
+// -------------------------------------------------------------------------
+// A fixed set of threads (one per core, minus the caller) for splitting
+// CPU-heavy analysis (Welch segments, spectrogram hops) into chunks.
+//
+// ParallelFor(n, grain, fn) calls fn(begin, end, slot) over [0, n) in
+// chunks of at least `grain` items and returns when all of them are done.
+// The calling thread works too. `slot` (< SlotsFor(n, grain)) is fixed per
+// thread for the duration of the call, so callers index per-thread scratch
+// buffers with it and never share one between threads. Slots are numbered
+// in the order threads pick up their first chunk, so a small call only
+// needs scratch for the few threads that can take part in it.
+//
+// One ParallelFor runs at a time; a call from inside a chunk (or when the
+// pool has no workers) runs inline on slot 0.
+
+class WorkerPool {
+public:
+  explicit WorkerPool(size_t threads) {
+    for (size_t i = 0; i < threads; i++) {
+      workers.emplace_back([this] { WorkerLoop(); });
+    }
+  }
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wakeCv.notify_all();
+    for (auto& t : workers) t.join();
+  }
+
+  // Number of threads that may run chunks (workers + caller)
+  size_t Slots() const { return workers.size() + 1; }
+
+  // Slots a ParallelFor(n, grain, ...) from this thread can hand out: 1 when
+  // it runs inline, otherwise at most one per chunk
+  size_t SlotsFor(size_t n, size_t grain) const {
+    grain = std::max<size_t>(grain, 1);
+    if (workers.empty() || n <= grain || InsideChunk()) return 1;
+    size_t chunk = ChunkSize(n, grain);
+    return std::min(Slots(), (n + chunk - 1) / chunk);
+  }
+
+  template <typename Fn>
+  void ParallelFor(size_t n, size_t grain, Fn&& fn) {
+    if (n == 0) return;
+    grain = std::max<size_t>(grain, 1);
+    if (workers.empty() || n <= grain || InsideChunk()) {
+      fn((size_t)0, n, (size_t)0);
+      return;
+    }
+
+    std::lock_guard<std::mutex> dispatch(dispatchMutex);
+    Job job;
+    job.n = n;
+    job.chunk = ChunkSize(n, grain);
+    job.ctx = &fn;
+    job.invoke = [](void* ctx, size_t begin, size_t end, size_t slot) {
+      (*static_cast<std::remove_reference_t<Fn>*>(ctx))(begin, end, slot);
+    };
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      current = &job;
+      generation++;
+    }
+    wakeCv.notify_all();
+
+    RunChunks(job);
+
+    // No new helpers after this; wait for the ones still finishing chunks
+    std::unique_lock<std::mutex> lock(mutex);
+    current = nullptr;
+    doneCv.wait(lock, [&] { return job.helpers == 0; });
+  }
+
+private:
+  struct Job {
+    size_t n = 0;
+    size_t chunk = 1;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> slots{0}; // Slots handed out so far
+    size_t helpers = 0; // Workers inside RunChunks (guarded by mutex)
+    void* ctx = nullptr;
+    void (*invoke)(void*, size_t, size_t, size_t) = nullptr;
+  };
+
+  static bool& InsideChunk() {
+    static thread_local bool inside = false;
+    return inside;
+  }
+
+  // A few chunks per thread balances uneven chunk costs
+  size_t ChunkSize(size_t n, size_t grain) const {
+    return std::max(grain, (n + Slots() * 4 - 1) / (Slots() * 4));
+  }
+
+  static void RunChunks(Job& job) {
+    InsideChunk() = true;
+    size_t slot = SIZE_MAX;
+    for (;;) {
+      size_t begin = job.next.fetch_add(job.chunk, std::memory_order_relaxed);
+      if (begin >= job.n) break;
+      if (slot == SIZE_MAX) slot = job.slots.fetch_add(1, std::memory_order_relaxed);
+      job.invoke(job.ctx, begin, std::min(job.n, begin + job.chunk), slot);
+    }
+    InsideChunk() = false;
+  }
+
+  void WorkerLoop() {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+      wakeCv.wait(lock, [&] { return stopping || generation != seen; });
+      if (stopping) return;
+      seen = generation;
+      Job* job = current;
+      if (!job) continue;
+      job->helpers++;
+      lock.unlock();
+      RunChunks(*job);
+      lock.lock();
+      if (--job->helpers == 0) doneCv.notify_all();
+    }
+  }
+
+  std::vector<std::thread> workers;
+  std::mutex dispatchMutex; // One ParallelFor at a time
+  std::mutex mutex;
+  std::condition_variable wakeCv;
+  std::condition_variable doneCv;
+  Job* current = nullptr;
+  uint64_t generation = 0;
+  bool stopping = false;
+};
+
+inline WorkerPool& GetWorkerPool() {
+  static WorkerPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+  return pool;
+}